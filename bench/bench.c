@@ -0,0 +1,337 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/lib/graph.h"
+#include "../src/lib/csr_graph.h"
+#include "../src/lib/person.h"
+#include "../src/lib/input.h"
+#include "../src/lib/arena.h"
+#include "../src/lib/pipeline.h"
+
+/**
+ * @brief Phases timed on each run, in the order they run on main.c.
+ */
+#define PHASE_INGEST 0
+#define PHASE_SORT 1
+#define PHASE_EDGES 2
+#define PHASE_SPREAD 3
+#define PHASE_TEARDOWN 4
+#define PHASES_NUMBER 5
+
+static const char *PHASE_NAMES[PHASES_NUMBER] = {
+    "ingest", "sort/index", "edges", "spread", "teardown"
+};
+
+/**
+ * @brief Options given by the harness arguments.
+ */
+struct bench_options {
+    /** Path of the input file, generated by tp0-generator. */
+    char *inputPath;
+    /** Amount of measured runs. */
+    int runs;
+    /** Amount of runs executed before the measured ones. */
+    int warmup;
+    /** If 1, the people are found through a hash index. */
+    int hash;
+    /** If 1, the edges are stored on a CSR graph. */
+    int csr;
+    /** If 1, the people, vertices and lists are allocated on an arena. */
+    int arena;
+    /** If 1, the spread uses the recursive traversal. */
+    int recursive;
+    /** SPREAD_DFS or SPREAD_BFS, for the iterative traversals. */
+    int strategy;
+    /** SORT_QUICKSORT or SORT_MULTIKEY, for the people ids sort. */
+    int sort;
+    /** Amount of threads of the multikey sort. */
+    int threads;
+};
+typedef struct bench_options BenchOptions;
+
+/**
+ * @brief Returns the monotonic clock time.
+ *
+ * @return double The time, in seconds.
+ */
+static double now() {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Parses a whole argument value as an integer.
+ *
+ * @param text The argument value.
+ * @param minimum The smallest value accepted.
+ * @param value Receives the parsed value.
+ * @return int 1 on success, 0 if the text is not an integer between minimum
+ * and INT_MAX - 1.
+ */
+static int parseInteger(const char *text, int minimum, int *value) {
+    char *end;
+    long number = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || number < minimum ||
+        number >= INT_MAX) {
+        return 0;
+    }
+    *value = (int) number;
+    return 1;
+}
+
+/**
+ * @brief Parses the harness arguments.
+ *
+ * @param argc The arguments count.
+ * @param argv The arguments.
+ * @param options Receives the parsed options.
+ * @return int 1 on success, 0 if an argument is unknown, invalid or missing.
+ */
+static int parseOptions(int argc, char *argv[], BenchOptions *options) {
+    options->inputPath = NULL;
+    options->runs = 5;
+    options->warmup = 1;
+    options->hash = 0;
+    options->csr = 0;
+    options->arena = 0;
+    options->recursive = 0;
+    options->strategy = SPREAD_DFS;
+    options->sort = SORT_QUICKSORT;
+    options->threads = 1;
+
+    for (int i = 1; i < argc; i += 1) {
+        if (strncmp(argv[i], "--input=", 8) == 0) {
+            options->inputPath = argv[i] + 8;
+        } else if (strncmp(argv[i], "--runs=", 7) == 0) {
+            if (!parseInteger(argv[i] + 7, 1, &options->runs)) {
+                fprintf(stderr, "Invalid amount of runs: %s\n", argv[i] + 7);
+                return 0;
+            }
+        } else if (strncmp(argv[i], "--warmup=", 9) == 0) {
+            if (!parseInteger(argv[i] + 9, 0, &options->warmup)) {
+                fprintf(stderr, "Invalid amount of warmup runs: %s\n",
+                    argv[i] + 9);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--hash") == 0) {
+            options->hash = 1;
+        } else if (strcmp(argv[i], "--csr") == 0) {
+            options->csr = 1;
+        } else if (strcmp(argv[i], "--arena") == 0) {
+            options->arena = 1;
+        } else if (strcmp(argv[i], "--spread=recursive") == 0) {
+            options->recursive = 1;
+        } else if (strcmp(argv[i], "--spread=dfs") == 0) {
+            options->recursive = 0;
+            options->strategy = SPREAD_DFS;
+        } else if (strcmp(argv[i], "--spread=bfs") == 0) {
+            options->recursive = 0;
+            options->strategy = SPREAD_BFS;
+        } else if (strcmp(argv[i], "--sort=quicksort") == 0) {
+            options->sort = SORT_QUICKSORT;
+        } else if (strcmp(argv[i], "--sort=multikey") == 0) {
+            options->sort = SORT_MULTIKEY;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            if (!parseInteger(argv[i] + 10, 1, &options->threads)) {
+                fprintf(stderr, "Invalid amount of threads: %s\n",
+                    argv[i] + 10);
+                return 0;
+            }
+        } else {
+            fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 0;
+        }
+    }
+
+    if (options->inputPath == NULL) {
+        fprintf(stderr, "Usage: tp0-bench --input=PATH [--runs=N] "
+            "[--warmup=N] [--hash] [--csr] [--arena] "
+            "[--spread=dfs|bfs|recursive] [--sort=quicksort|multikey] "
+            "[--threads=N]\n");
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Releases everything a run allocated.
+ *
+ * @param input The input.
+ * @param graph The graph.
+ * @param people The amount of people read into the graph.
+ * @param arena The arena, or NULL.
+ * @param csr The CSR graph, or NULL.
+ * @param index The hash index, or NULL.
+ */
+static void releaseRun(Input *input, Graph *graph, int people, Arena *arena,
+    CsrGraph *csr, PersonIndex *index) {
+    if (csr) {
+        CsrGraph_destroy(csr);
+    }
+    if (index) {
+        PersonIndex_destroy(index);
+    }
+    if (arena) {
+        Arena_destroy(arena);
+    } else if (people == Graph_getVerticesNumber(graph)) {
+        Graph_destroyPeople(graph);
+    } else {
+        // Only the first vertices were inserted by an interrupted read.
+        Vertex **vertices = Graph_getVertices(graph);
+        for (int i = 0; i < people; i += 1) {
+            Person_destroy(Vertex_getData(vertices[i]));
+            Vertex_destroy(vertices[i]);
+        }
+    }
+    Graph_destroy(graph);
+    Input_close(input);
+}
+
+/**
+ * @brief Runs the whole program once over the input, timing each phase.
+ *
+ * @param options The harness options.
+ * @param times Receives the duration of each phase, in seconds.
+ * @return int The spread count, or -1 if the input is invalid.
+ */
+static int runOnce(BenchOptions *options, double *times) {
+    int n, m, counter = 0;
+    double start = now();
+
+    Input *input = Input_open(options->inputPath);
+    if (input == NULL) {
+        return -1;
+    }
+    if (!Input_nextInt(input, &n) || !Input_nextInt(input, &m) || n < 0 ||
+        m < 0) {
+        Input_close(input);
+        return -1;
+    }
+
+    Graph *graph = Graph_create(n);
+    Arena *arena = options->arena ? Arena_create() : NULL;
+    CsrGraph *csr = options->csr ? CsrGraph_create(n) : NULL;
+    int people = Pipeline_readPeople(input, graph, arena, n);
+    if (people < n) {
+        releaseRun(input, graph, people, arena, csr, NULL);
+        return -1;
+    }
+    times[PHASE_INGEST] = now() - start;
+
+    start = now();
+    PersonIndex *index = Pipeline_indexPeople(graph, options->hash,
+        options->sort, options->threads);
+    times[PHASE_SORT] = now() - start;
+
+    start = now();
+    Pipeline_readEdges(input, m, graph, index, csr, NULL, NULL);
+    times[PHASE_EDGES] = now() - start;
+
+    char *first_id = Input_nextToken(input, NULL);
+    int start_index = first_id ?
+        Pipeline_searchPerson(graph, index, first_id) : -1;
+    start = now();
+    if (start_index >= 0) {
+        counter = Pipeline_spreadMusic(graph, csr, NULL, NULL, start_index,
+            options->recursive, options->strategy);
+    }
+    times[PHASE_SPREAD] = now() - start;
+
+    start = now();
+    releaseRun(input, graph, n, arena, csr, index);
+    times[PHASE_TEARDOWN] = now() - start;
+
+    return counter;
+}
+
+/**
+ * @brief Comparison function used to sort the samples.
+ */
+static int compareDoubles(const void *a, const void *b) {
+    double difference = *(const double *) a - *(const double *) b;
+    return (difference > 0) - (difference < 0);
+}
+
+/**
+ * @brief Returns the given percentile of the sorted samples, using the nearest
+ * rank method.
+ *
+ * @param samples The sorted samples.
+ * @param length The amount of samples.
+ * @param percentile The percentile, from 0 to 100.
+ * @return double The sample on the percentile.
+ */
+static double getPercentile(double *samples, int length, int percentile) {
+    int rank = (percentile * length + 99) / 100;
+    if (rank < 1) {
+        rank = 1;
+    }
+    return samples[rank - 1];
+}
+
+/**
+ * @brief Benchmark harness main function.
+ *
+ * Runs the program phases over the input file "--runs" times, after
+ * "--warmup" unmeasured runs, and prints the minimum, the 50th, 90th and 99th
+ * percentiles, the maximum and the mean of each phase, in milliseconds.
+ *
+ * @param argc The arguments count.
+ * @param argv The arguments.
+ * @return int Program's exit status code.
+ */
+int main(int argc, char *argv[]) {
+    BenchOptions options;
+    int i, phase, counter = 0;
+
+    if (!parseOptions(argc, argv, &options)) {
+        return 1;
+    }
+
+    double *samples = (double *) malloc(options.runs * PHASES_NUMBER *
+        sizeof(double));
+    double times[PHASES_NUMBER];
+
+    for (i = -options.warmup; i < options.runs; i += 1) {
+        counter = runOnce(&options, times);
+        if (counter < 0) {
+            fprintf(stderr, "Invalid input: %s\n", options.inputPath);
+            free(samples);
+            return 1;
+        }
+        Person_resetSpread();
+        if (i < 0) {
+            continue;
+        }
+        for (phase = 0; phase < PHASES_NUMBER; phase += 1) {
+            samples[phase * options.runs + i] = times[phase];
+        }
+    }
+
+    printf("count %d, %d runs\n", counter, options.runs);
+    printf("%-12s %10s %10s %10s %10s %10s %10s\n", "phase (ms)", "min",
+        "p50", "p90", "p99", "max", "mean");
+    for (phase = 0; phase < PHASES_NUMBER; phase += 1) {
+        double *phaseSamples = samples + phase * options.runs;
+        double sum = 0;
+        qsort(phaseSamples, options.runs, sizeof(double), compareDoubles);
+        for (i = 0; i < options.runs; i += 1) {
+            sum += phaseSamples[i];
+        }
+        printf("%-12s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+            PHASE_NAMES[phase],
+            phaseSamples[0] * 1e3,
+            getPercentile(phaseSamples, options.runs, 50) * 1e3,
+            getPercentile(phaseSamples, options.runs, 90) * 1e3,
+            getPercentile(phaseSamples, options.runs, 99) * 1e3,
+            phaseSamples[options.runs - 1] * 1e3,
+            sum / options.runs * 1e3);
+    }
+
+    free(samples);
+    return 0;
+}
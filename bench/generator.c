@@ -0,0 +1,293 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Parameters of the generated graph.
+ */
+struct generator_options {
+    /** Amount of people (program input "n"). */
+    int people;
+    /** Amount of relationships (program input "m"). */
+    int edges;
+    /** Amount of spread queries appended after the edges. */
+    int queries;
+    /** Ages are drawn uniformly from [minAge, maxAge]. */
+    int minAge;
+    int maxAge;
+    /** Amount of families the people are split into. */
+    int families;
+    /** Percentage of the relationships inside the same family. */
+    int locality;
+    /** Length of each id, including the prefix. */
+    int idLength;
+    /** Prefix shared by all the ids. */
+    char *prefix;
+    /** Seed of the random number generator. */
+    unsigned long long seed;
+};
+typedef struct generator_options GeneratorOptions;
+
+/**
+ * @brief State of the xorshift64* random number generator.
+ */
+static unsigned long long random_state;
+
+/**
+ * @brief Returns the next pseudo-random number.
+ *
+ * Complexity: O(1).
+ *
+ * @return unsigned long long A 64 bits random number.
+ */
+static unsigned long long nextRandom() {
+    random_state ^= random_state >> 12;
+    random_state ^= random_state << 25;
+    random_state ^= random_state >> 27;
+    return random_state * 2685821657736338717ULL;
+}
+
+/**
+ * @brief Returns a pseudo-random number on [0, bound).
+ *
+ * Complexity: O(1).
+ *
+ * @param bound The exclusive upper bound. Must be positive.
+ * @return int The random number.
+ */
+static int nextBounded(int bound) {
+    return (int) (nextRandom() % (unsigned long long) bound);
+}
+
+/**
+ * @brief Writes the id of the given person: the prefix followed by the person
+ * number in base 36, left padded with zeros up to the id length.
+ *
+ * Complexity: O(idLength).
+ *
+ * @param options The generator options.
+ * @param person The person number.
+ * @param id Receives the id. Must have idLength + 1 bytes.
+ */
+static void writeId(GeneratorOptions *options, int person, char *id) {
+    const char *digits = "0123456789abcdefghijklmnopqrstuvwxyz";
+    int prefixLength = strlen(options->prefix);
+    int i;
+
+    memcpy(id, options->prefix, prefixLength);
+    for (i = options->idLength - 1; i >= prefixLength; i -= 1) {
+        id[i] = digits[person % 36];
+        person /= 36;
+    }
+    id[options->idLength] = '\0';
+}
+
+/**
+ * @brief Parses a whole argument value as an integer.
+ *
+ * @param text The argument value.
+ * @param value Receives the parsed value.
+ * @return int 1 on success, 0 if the text is not an integer that fits on an
+ * int.
+ */
+static int parseInteger(const char *text, int *value) {
+    char *end;
+    long number = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || number < INT_MIN ||
+        number > INT_MAX) {
+        return 0;
+    }
+    *value = (int) number;
+    return 1;
+}
+
+/**
+ * @brief Checks if the digits left after the prefix give a distinct id to
+ * each person.
+ *
+ * @param options The generator options.
+ * @return int 1 if they do, 0 if some ids would repeat.
+ */
+static int hasEnoughIds(GeneratorOptions *options) {
+    int digits = options->idLength - (int) strlen(options->prefix);
+    long long ids = 1;
+
+    for (int i = 0; i < digits && ids < options->people; i += 1) {
+        ids *= 36;
+    }
+    return ids >= options->people;
+}
+
+/**
+ * @brief Parses the generator arguments.
+ *
+ * @param argc The arguments count.
+ * @param argv The arguments.
+ * @param options Receives the parsed options.
+ * @return int 1 on success, 0 if an argument is unknown or invalid.
+ */
+static int parseOptions(int argc, char *argv[], GeneratorOptions *options) {
+    options->people = 1000;
+    options->edges = 2000;
+    options->queries = 0;
+    options->minAge = 1;
+    options->maxAge = 90;
+    options->families = 100;
+    options->locality = 90;
+    options->idLength = 12;
+    options->prefix = "";
+    options->seed = 1;
+
+    for (int i = 1; i < argc; i += 1) {
+        char *value = strchr(argv[i], '=');
+        int parsed = 1;
+        if (value == NULL) {
+            fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 0;
+        }
+        value += 1;
+
+        if (strncmp(argv[i], "--people=", 9) == 0) {
+            parsed = parseInteger(value, &options->people);
+        } else if (strncmp(argv[i], "--edges=", 8) == 0) {
+            parsed = parseInteger(value, &options->edges);
+        } else if (strncmp(argv[i], "--queries=", 10) == 0) {
+            parsed = parseInteger(value, &options->queries);
+        } else if (strncmp(argv[i], "--min-age=", 10) == 0) {
+            parsed = parseInteger(value, &options->minAge);
+        } else if (strncmp(argv[i], "--max-age=", 10) == 0) {
+            parsed = parseInteger(value, &options->maxAge);
+        } else if (strncmp(argv[i], "--families=", 11) == 0) {
+            parsed = parseInteger(value, &options->families);
+        } else if (strncmp(argv[i], "--locality=", 11) == 0) {
+            parsed = parseInteger(value, &options->locality);
+        } else if (strncmp(argv[i], "--id-length=", 12) == 0) {
+            parsed = parseInteger(value, &options->idLength);
+        } else if (strncmp(argv[i], "--prefix=", 9) == 0) {
+            options->prefix = value;
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            options->seed = strtoull(value, NULL, 10);
+        } else {
+            fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 0;
+        }
+        if (!parsed) {
+            fprintf(stderr, "Invalid number: %s\n", argv[i]);
+            return 0;
+        }
+    }
+
+    if (
+        options->people < 1 ||
+        options->edges < 0 ||
+        options->queries < 0 ||
+        options->families < 1 ||
+        options->families > options->people ||
+        options->minAge > options->maxAge ||
+        options->locality < 0 ||
+        options->locality > 100 ||
+        options->idLength < (int) strlen(options->prefix) + 1
+    ) {
+        fprintf(stderr, "Invalid generator options\n");
+        return 0;
+    }
+    // Base 36 ids wrap around when they have too few digits.
+    if (!hasEnoughIds(options)) {
+        fprintf(stderr, "--id-length=%d is too short for %d distinct ids\n",
+            options->idLength, options->people);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Generator main function.
+ *
+ * Writes a synthetic family graph on the standard output, in the program
+ * input format. The people are split into contiguous families, and each
+ * relationship joins two people of the same family with the "--locality"
+ * percentage, or two random people otherwise. The people are written in a
+ * random order, so the input is not sorted by id. After the edges, the id of
+ * the first listener is written, followed by "--queries" extra ids for the
+ * batch mode. The first listener is always younger than 35, if there is anyone
+ * younger than 35.
+ *
+ * Complexity: O(n+m).
+ *
+ * @param argc The arguments count.
+ * @param argv The arguments.
+ * @return int Program's exit status code.
+ */
+int main(int argc, char *argv[]) {
+    GeneratorOptions options;
+    int i;
+
+    if (!parseOptions(argc, argv, &options)) {
+        return 1;
+    }
+    random_state = options.seed * 2654435761ULL + 88172645463325252ULL;
+
+    int *order = (int *) malloc(options.people * sizeof(int));
+    int *ages = (int *) malloc(options.people * sizeof(int));
+    char *id = (char *) malloc(options.idLength + 1);
+    int familySize = options.people / options.families;
+    int first = -1;
+
+    for (i = 0; i < options.people; i += 1) {
+        order[i] = i;
+        ages[i] = options.minAge + nextBounded(options.maxAge -
+            options.minAge + 1);
+        if (first < 0 && ages[i] < 35) {
+            first = i;
+        }
+    }
+    for (i = options.people - 1; i > 0; i -= 1) {
+        int j = nextBounded(i + 1);
+        int person = order[i];
+        order[i] = order[j];
+        order[j] = person;
+    }
+
+    printf("%d %d\n", options.people, options.edges);
+    for (i = 0; i < options.people; i += 1) {
+        writeId(&options, order[i], id);
+        printf("%s %d\n", id, ages[order[i]]);
+    }
+
+    for (i = 0; i < options.edges; i += 1) {
+        int person1 = nextBounded(options.people);
+        int person2;
+        if (nextBounded(100) < options.locality) {
+            int family = person1 / familySize;
+            if (family >= options.families) {
+                family = options.families - 1;
+            }
+            int familyStart = family * familySize;
+            int familyEnd = family == options.families - 1 ?
+                options.people : familyStart + familySize;
+            person2 = familyStart + nextBounded(familyEnd - familyStart);
+        } else {
+            person2 = nextBounded(options.people);
+        }
+
+        writeId(&options, person1, id);
+        printf("%s ", id);
+        writeId(&options, person2, id);
+        printf("%s\n", id);
+    }
+
+    writeId(&options, first >= 0 ? first : 0, id);
+    printf("%s\n", id);
+    for (i = 0; i < options.queries; i += 1) {
+        writeId(&options, nextBounded(options.people), id);
+        printf("%s\n", id);
+    }
+
+    free(order);
+    free(ages);
+    free(id);
+
+    return 0;
+}
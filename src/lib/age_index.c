@@ -0,0 +1,357 @@
+#include <stdlib.h>
+#include <string.h>
+#include "age_index.h"
+
+/**
+ * @brief Initial capacity of the edges arrays.
+ */
+#define AGE_INDEX_INITIAL_EDGES 1024
+
+/**
+ * @brief AgeIndex structure.
+ *
+ * Kruskal reconstruction tree of the graph, with the people added in
+ * increasing age order. Its leaves are the vertices, weighted by their ages,
+ * and each internal node is the merge of two components, weighted by the age
+ * that connected them: the larger age of the edge that merged them. The
+ * weights never decrease going up, so the people reached from a seed through
+ * people younger than a threshold are the leaves of its highest ancestor
+ * lighter than the threshold.
+ *
+ * That ancestor is found with jump pointers (Myers, 1983): besides its
+ * parent, each node points to an ancestor chosen so any ancestor is reached
+ * in O(log(n)) steps, with a single extra integer per node.
+ */
+struct age_index {
+    /** The amount of vertices, which are the tree leaves. */
+    int verticesNumber;
+    /** The amount of tree nodes, at most 2*verticesNumber - 1. */
+    int nodesNumber;
+    /** Weight of each node: the age of a leaf or the merge age. */
+    int *weights;
+    /** Parent of each node, or -1 for the roots. */
+    int *parents;
+    /** Jump pointer of each node. Roots point to themselves. */
+    int *jumps;
+    /** Amount of leaves under each node. */
+    int *sizes;
+    /** First vertex of each inserted edge. Released by the build. */
+    int *edges1;
+    /** Second vertex of each inserted edge. Released by the build. */
+    int *edges2;
+    /** Amount of inserted edges. */
+    int edgesNumber;
+    /** Allocated length of the edges arrays. */
+    int edgesCapacity;
+};
+
+/**
+ * @brief Creates an index with no edges.
+ *
+ * n: The amount of vertices.
+ * Complexity: O(n).
+ *
+ * @param ages The age of each vertex. It is copied.
+ * @param verticesNumber The amount of vertices.
+ * @return AgeIndex* A pointer to the created index, or NULL if it could not
+ * be allocated.
+ */
+AgeIndex * AgeIndex_create(const int *ages, int verticesNumber) {
+    AgeIndex *index = (AgeIndex *) malloc(sizeof(AgeIndex));
+    size_t nodes = 2 * (size_t) verticesNumber + 1;
+
+    if (index == NULL) {
+        return NULL;
+    }
+    index->verticesNumber = verticesNumber;
+    index->nodesNumber = verticesNumber;
+    index->weights = (int *) malloc(nodes * sizeof(int));
+    index->parents = (int *) malloc(nodes * sizeof(int));
+    index->jumps = (int *) malloc(nodes * sizeof(int));
+    index->sizes = (int *) malloc(nodes * sizeof(int));
+    index->edgesNumber = 0;
+    index->edgesCapacity = AGE_INDEX_INITIAL_EDGES;
+    index->edges1 = (int *) malloc(index->edgesCapacity * sizeof(int));
+    index->edges2 = (int *) malloc(index->edgesCapacity * sizeof(int));
+    if (index->weights == NULL || index->parents == NULL ||
+        index->jumps == NULL || index->sizes == NULL ||
+        index->edges1 == NULL || index->edges2 == NULL) {
+        AgeIndex_destroy(index);
+        return NULL;
+    }
+
+    memcpy(index->weights, ages, verticesNumber * sizeof(int));
+    for (int i = 0; i < verticesNumber; i += 1) {
+        index->parents[i] = -1;
+        index->jumps[i] = i;
+        index->sizes[i] = 1;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Destroys the given index.
+ *
+ * Complexity: O(1).
+ *
+ * @param index The index to be destroyed.
+ */
+void AgeIndex_destroy(AgeIndex *index) {
+    free(index->weights);
+    free(index->parents);
+    free(index->jumps);
+    free(index->sizes);
+    free(index->edges1);
+    free(index->edges2);
+    free(index);
+}
+
+/**
+ * @brief Registers an edge. The edges are only merged by AgeIndex_build.
+ *
+ * Complexity: O(1) amortized.
+ *
+ * @param index The index, not built yet.
+ * @param vertex1 A vertex of the edge.
+ * @param vertex2 The other vertex of the edge.
+ * @return int 1 on success, 0 if the edges arrays could not grow. The index
+ * keeps the edges inserted before.
+ */
+int AgeIndex_insertEdge(AgeIndex *index, int vertex1, int vertex2) {
+    if (index->edgesNumber == index->edgesCapacity) {
+        size_t size = 2 * (size_t) index->edgesCapacity * sizeof(int);
+        int *edges1 = (int *) realloc(index->edges1, size);
+        if (edges1 == NULL) {
+            return 0;
+        }
+        index->edges1 = edges1;
+        int *edges2 = (int *) realloc(index->edges2, size);
+        if (edges2 == NULL) {
+            return 0;
+        }
+        index->edges2 = edges2;
+        index->edgesCapacity *= 2;
+    }
+
+    index->edges1[index->edgesNumber] = vertex1;
+    index->edges2[index->edgesNumber] = vertex2;
+    index->edgesNumber += 1;
+    return 1;
+}
+
+/**
+ * @brief Ages being sorted, used by the sort comparison.
+ */
+static const int *age_index_sorting;
+
+/**
+ * @brief Compares two vertices by their ages.
+ */
+static int AgeIndex_compareAges(const void *a, const void *b) {
+    int age1 = age_index_sorting[*(const int *) a];
+    int age2 = age_index_sorting[*(const int *) b];
+    return (age1 > age2) - (age1 < age2);
+}
+
+/**
+ * @brief Finds the root of the set of the given vertex, halving the path on
+ * the way.
+ *
+ * Complexity: O(α(n)) amortized.
+ *
+ * @param sets The parent of each vertex on its set tree.
+ * @param vertex The vertex.
+ * @return int The root of the vertex set.
+ */
+static int AgeIndex_find(int *sets, int vertex) {
+    while (sets[vertex] != vertex) {
+        sets[vertex] = sets[sets[vertex]];
+        vertex = sets[vertex];
+    }
+    return vertex;
+}
+
+/**
+ * @brief Sorts the edges by the age that activates them, the larger age of
+ * their vertices. The vertices are ranked by age and the edges are bucketed
+ * by the rank of their older vertex.
+ *
+ * n: The amount of vertices.
+ * m: The amount of edges.
+ * Complexity: O(n*log(n)+m).
+ *
+ * @param index The index.
+ * @param sorted1 Receives the first vertex of each sorted edge.
+ * @param sorted2 Receives the second vertex of each sorted edge.
+ * @return int 1 on success, 0 if the ranks could not be allocated.
+ */
+static int AgeIndex_sortEdges(AgeIndex *index, int *sorted1, int *sorted2) {
+    int length = index->verticesNumber;
+    int *order = (int *) malloc((length + 1) * sizeof(int));
+    int *ranks = (int *) malloc((length + 1) * sizeof(int));
+    int *starts = (int *) calloc(length + 1, sizeof(int));
+    int i;
+
+    if (order == NULL || ranks == NULL || starts == NULL) {
+        free(order);
+        free(ranks);
+        free(starts);
+        return 0;
+    }
+
+    for (i = 0; i < length; i += 1) {
+        order[i] = i;
+    }
+    age_index_sorting = index->weights;
+    qsort(order, length, sizeof(int), AgeIndex_compareAges);
+    for (i = 0; i < length; i += 1) {
+        ranks[order[i]] = i;
+    }
+
+    for (i = 0; i < index->edgesNumber; i += 1) {
+        int rank1 = ranks[index->edges1[i]], rank2 = ranks[index->edges2[i]];
+        starts[(rank1 > rank2 ? rank1 : rank2) + 1] += 1;
+    }
+    for (i = 0; i < length; i += 1) {
+        starts[i + 1] += starts[i];
+    }
+    for (i = 0; i < index->edgesNumber; i += 1) {
+        int rank1 = ranks[index->edges1[i]], rank2 = ranks[index->edges2[i]];
+        int position = starts[rank1 > rank2 ? rank1 : rank2]++;
+        sorted1[position] = index->edges1[i];
+        sorted2[position] = index->edges2[i];
+    }
+
+    free(order);
+    free(ranks);
+    free(starts);
+    return 1;
+}
+
+/**
+ * @brief Builds the reconstruction tree from the inserted edges, merging them
+ * in increasing activation age with a union-find, and then sets the jump
+ * pointers. The edges are released.
+ *
+ * n: The amount of vertices.
+ * m: The amount of edges.
+ * Complexity: O(n*log(n)+m*α(n)).
+ *
+ * @param index The index.
+ * @return int 1 on success, 0 if the build could not allocate its work
+ * arrays. The index is then left unbuilt and can only be destroyed.
+ */
+int AgeIndex_build(AgeIndex *index) {
+    int length = index->verticesNumber;
+    // Sized for the nodes, so the depths reuse it without a realloc.
+    int *sets = (int *) malloc((2 * (size_t) length + 1) * sizeof(int));
+    int *sorted1 = (int *) malloc((index->edgesNumber + 1) * sizeof(int));
+    int *sorted2 = (int *) malloc((index->edgesNumber + 1) * sizeof(int));
+    int *setSizes = (int *) malloc((length + 1) * sizeof(int));
+    int *setNodes = (int *) malloc((length + 1) * sizeof(int));
+    int i;
+
+    if (sets == NULL || sorted1 == NULL || sorted2 == NULL ||
+        setSizes == NULL || setNodes == NULL ||
+        !AgeIndex_sortEdges(index, sorted1, sorted2)) {
+        free(sets);
+        free(sorted1);
+        free(sorted2);
+        free(setSizes);
+        free(setNodes);
+        return 0;
+    }
+    free(index->edges1);
+    free(index->edges2);
+    index->edges1 = index->edges2 = NULL;
+
+    for (i = 0; i < length; i += 1) {
+        sets[i] = i;
+        setSizes[i] = 1;
+        setNodes[i] = i;
+    }
+
+    for (i = 0; i < index->edgesNumber; i += 1) {
+        int vertex1 = sorted1[i], vertex2 = sorted2[i];
+        int root1 = AgeIndex_find(sets, vertex1);
+        int root2 = AgeIndex_find(sets, vertex2);
+        if (root1 == root2) {
+            continue;
+        }
+
+        int node = index->nodesNumber++;
+        int child1 = setNodes[root1], child2 = setNodes[root2];
+        index->weights[node] = index->weights[vertex1] >
+            index->weights[vertex2] ? index->weights[vertex1] :
+            index->weights[vertex2];
+        index->parents[node] = -1;
+        index->sizes[node] = index->sizes[child1] + index->sizes[child2];
+        index->parents[child1] = index->parents[child2] = node;
+
+        if (setSizes[root1] < setSizes[root2]) {
+            int root = root1;
+            root1 = root2;
+            root2 = root;
+        }
+        sets[root2] = root1;
+        setSizes[root1] += setSizes[root2];
+        setNodes[root1] = node;
+    }
+
+    // The parents are created after their children, so they get their jump
+    // pointers first. "sets" is reused as the depth of each node.
+    int *depths = sets;
+    for (i = index->nodesNumber - 1; i >= 0; i -= 1) {
+        int parent = index->parents[i];
+        if (parent == -1) {
+            depths[i] = 0;
+            index->jumps[i] = i;
+            continue;
+        }
+
+        int jump = index->jumps[parent];
+        depths[i] = depths[parent] + 1;
+        index->jumps[i] = depths[parent] - depths[jump] ==
+            depths[jump] - depths[index->jumps[jump]] ?
+            index->jumps[jump] : parent;
+    }
+
+    free(sorted1);
+    free(sorted2);
+    free(depths);
+    free(setSizes);
+    free(setNodes);
+    return 1;
+}
+
+/**
+ * @brief Getter for the spread count of the given vertex with the given age
+ * threshold: how many people younger than it would like the music if it
+ * started on the vertex, spreading only through people younger than it.
+ *
+ * n: The amount of vertices.
+ * Complexity: O(log(n)).
+ *
+ * @param index The built index.
+ * @param vertex The vertex.
+ * @param threshold The age limit, SPREAD_AGE_LIMIT on the original program.
+ * @return int The count. 0 if the vertex is not younger than the threshold.
+ */
+int AgeIndex_getCount(AgeIndex *index, int vertex, int threshold) {
+    int *weights = index->weights;
+    int *parents = index->parents;
+    int node = vertex;
+
+    if (weights[vertex] >= threshold) {
+        return 0;
+    }
+
+    while (parents[node] != -1 && weights[parents[node]] < threshold) {
+        int jump = index->jumps[node];
+        node = jump != node && weights[jump] < threshold ? jump :
+            parents[node];
+    }
+
+    return index->sizes[node];
+}
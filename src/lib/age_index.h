@@ -0,0 +1,16 @@
+#ifndef AGE_INDEX_H
+#define AGE_INDEX_H
+
+typedef struct age_index AgeIndex;
+
+AgeIndex * AgeIndex_create(const int *ages, int verticesNumber);
+
+void AgeIndex_destroy(AgeIndex *index);
+
+int AgeIndex_insertEdge(AgeIndex *index, int vertex1, int vertex2);
+
+int AgeIndex_build(AgeIndex *index);
+
+int AgeIndex_getCount(AgeIndex *index, int vertex, int threshold);
+
+#endif
@@ -0,0 +1,114 @@
+#include <stdlib.h>
+#include "arena.h"
+
+/**
+ * @brief Default size of each arena block.
+ */
+#define ARENA_BLOCK_SIZE (1 << 20)
+
+/**
+ * @brief Alignment of every allocation made on the arena.
+ */
+#define ARENA_ALIGNMENT 16
+
+/**
+ * @brief Block structure. The allocations are made on the bytes right after
+ * the block header.
+ */
+struct arena_block {
+    /** The block allocated before this one. */
+    struct arena_block *previous;
+    /** Amount of bytes available for allocations on the block. */
+    size_t size;
+};
+typedef struct arena_block ArenaBlock;
+
+/**
+ * @brief Arena structure.
+ *
+ * Region allocator. Memory is taken from large blocks by bumping a pointer,
+ * and it is never released individually: destroying the arena releases every
+ * allocation made on it at once.
+ */
+struct arena {
+    /** The block where the allocations are being made. */
+    ArenaBlock *current;
+    /** Address of the next free byte on the current block. */
+    char *next;
+    /** Address after the last byte of the current block. */
+    char *end;
+};
+
+/**
+ * @brief Size of the block header, rounded up to keep the allocations
+ * aligned.
+ */
+#define ARENA_HEADER_SIZE \
+    ((sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) & \
+    ~(size_t) (ARENA_ALIGNMENT - 1))
+
+/**
+ * @brief Creates an empty arena. No block is allocated until the first
+ * allocation.
+ *
+ * Complexity: O(1).
+ *
+ * @return Arena* A pointer to the created arena.
+ */
+Arena * Arena_create() {
+    Arena *arena = (Arena *) malloc(sizeof(Arena));
+    arena->current = NULL;
+    arena->next = NULL;
+    arena->end = NULL;
+    return arena;
+}
+
+/**
+ * @brief Destroys the arena and every allocation made on it.
+ *
+ * n: The amount of blocks.
+ * Complexity: O(n).
+ *
+ * @param arena The arena to be destroyed.
+ */
+void Arena_destroy(Arena *arena) {
+    ArenaBlock *block = arena->current;
+    while (block != NULL) {
+        ArenaBlock *previous = block->previous;
+        free(block);
+        block = previous;
+    }
+    free(arena);
+}
+
+/**
+ * @brief Allocates memory on the arena.
+ *
+ * When the current block does not have enough space, a new block is allocated
+ * with the default size or with the requested size, if it is larger. The
+ * space left on the old block is not used anymore.
+ *
+ * Complexity: O(1).
+ *
+ * @param arena The arena.
+ * @param size The amount of bytes.
+ * @return void* Pointer to the allocated memory, aligned to 16 bytes.
+ */
+void * Arena_alloc(Arena *arena, size_t size) {
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t) (ARENA_ALIGNMENT - 1);
+
+    if (arena->current == NULL || (size_t) (arena->end - arena->next) < size) {
+        size_t blockSize = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+        ArenaBlock *block = (ArenaBlock *) malloc(ARENA_HEADER_SIZE +
+            blockSize);
+        block->previous = arena->current;
+        block->size = blockSize;
+        arena->current = block;
+        arena->next = (char *) block + ARENA_HEADER_SIZE;
+        arena->end = arena->next + blockSize;
+    }
+
+    void *pointer = arena->next;
+    arena->next += size;
+    return pointer;
+}
@@ -0,0 +1,14 @@
+#include <stddef.h>
+
+#ifndef ARENA_H
+#define ARENA_H
+
+typedef struct arena Arena;
+
+Arena * Arena_create();
+
+void Arena_destroy(Arena *arena);
+
+void * Arena_alloc(Arena *arena, size_t size);
+
+#endif
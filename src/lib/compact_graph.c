@@ -0,0 +1,243 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "compact_graph.h"
+
+/**
+ * @brief Neighbor lists shorter than this are sorted by insertion.
+ */
+#define COMPACT_INSERTION_LENGTH 16
+
+/**
+ * @brief Initial capacity of the encoded bytes buffer, per neighbor entry.
+ */
+#define COMPACT_INITIAL_BYTES_PER_ENTRY 2
+
+/**
+ * @brief CompactGraph structure.
+ *
+ * Read only graph with the neighbor lists compressed. The neighbors of each
+ * vertex are sorted and stored as the gaps between consecutive ones, each gap
+ * written as a variable length integer: 7 bits per byte, with the high bit set
+ * on every byte but the last. The first gap is taken from the vertex itself,
+ * signed, so a graph whose neighbors have close indices (see Reorder_compute)
+ * spends a single byte on most entries, instead of the 4 of the CSR graph.
+ *
+ * The neighbors of the vertex "v" are encoded on bytes[offsets[v]] until
+ * bytes[offsets[v + 1] - 1], and are read with a CompactIterator.
+ */
+struct compact_graph {
+    /** The amount of vertices. */
+    int verticesNumber;
+    /** Array with verticesNumber + 1 byte positions delimiting each
+     * neighborhood. */
+    unsigned int *offsets;
+    /** The encoded neighbors of all vertices, grouped by vertex. */
+    unsigned char *bytes;
+};
+
+/**
+ * @brief Compares two vertices indices.
+ */
+static int CompactGraph_compareVertices(const void *a, const void *b) {
+    int vertex1 = *(const int *) a, vertex2 = *(const int *) b;
+    return (vertex1 > vertex2) - (vertex1 < vertex2);
+}
+
+/**
+ * @brief Sorts a neighbor list by increasing index.
+ *
+ * n: The list length.
+ * Complexity: O(n*log(n)).
+ */
+static void CompactGraph_sortNeighbors(int *neighbors, int length) {
+    if (length > COMPACT_INSERTION_LENGTH) {
+        qsort(neighbors, length, sizeof(int), CompactGraph_compareVertices);
+        return;
+    }
+    for (int i = 1; i < length; i += 1) {
+        int vertex = neighbors[i];
+        int j = i - 1;
+        while (j >= 0 && neighbors[j] > vertex) {
+            neighbors[j + 1] = neighbors[j];
+            j -= 1;
+        }
+        neighbors[j + 1] = vertex;
+    }
+}
+
+/**
+ * @brief Writes a value as a variable length integer.
+ *
+ * Complexity: O(1).
+ *
+ * @param bytes The buffer, with at least 5 free bytes.
+ * @param value The value.
+ * @return int The amount of bytes written.
+ */
+static int CompactGraph_writeVarint(unsigned char *bytes, unsigned int value) {
+    int length = 0;
+    while (value >= 0x80) {
+        bytes[length++] = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+    bytes[length++] = (unsigned char) value;
+    return length;
+}
+
+/**
+ * @brief Creates a compressed copy of a built CSR graph. The CSR graph is not
+ * changed, so the caller may destroy it afterwards.
+ *
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * Complexity: O(V+E*log(E/V)).
+ *
+ * @param csr The built CSR graph.
+ * @return CompactGraph* A pointer to the created graph, or NULL if the
+ * encoded neighbors do not fit on the 32 bits offsets.
+ */
+CompactGraph * CompactGraph_createFromCsr(CsrGraph *csr) {
+    int length = CsrGraph_getVerticesNumber(csr);
+    size_t capacity = (size_t) CsrGraph_getNeighborsNumber(csr) *
+        COMPACT_INITIAL_BYTES_PER_ENTRY + 16;
+    size_t size = 0;
+    unsigned int *offsets = (unsigned int *) malloc((length + 1) *
+        sizeof(unsigned int));
+    unsigned char *bytes = (unsigned char *) malloc(capacity);
+    int *sorted = NULL;
+    int sortedCapacity = 0, i;
+
+    for (i = 0; i < length; i += 1) {
+        int degree = CsrGraph_getDegree(csr, i);
+        if (degree > sortedCapacity) {
+            sortedCapacity = degree;
+            sorted = (int *) realloc(sorted, sortedCapacity * sizeof(int));
+        }
+        memcpy(sorted, CsrGraph_getNeighbors(csr, i), degree * sizeof(int));
+        CompactGraph_sortNeighbors(sorted, degree);
+
+        // Each gap takes at most 5 bytes.
+        if (size + (size_t) degree * 5 > capacity) {
+            capacity = capacity * 2 + (size_t) degree * 5;
+            bytes = (unsigned char *) realloc(bytes, capacity);
+        }
+        if (size > UINT_MAX) {
+            break;
+        }
+
+        offsets[i] = (unsigned int) size;
+        int previous = i;
+        for (int j = 0; j < degree; j += 1) {
+            unsigned int gap = (unsigned int) (sorted[j] - previous);
+            if (j == 0) {
+                int delta = sorted[j] - previous;
+                gap = ((unsigned int) delta << 1) ^ (unsigned int) -(delta < 0);
+            }
+            size += CompactGraph_writeVarint(bytes + size, gap);
+            previous = sorted[j];
+        }
+    }
+    free(sorted);
+
+    if (i < length || size > UINT_MAX) {
+        free(offsets);
+        free(bytes);
+        return NULL;
+    }
+    offsets[length] = (unsigned int) size;
+
+    CompactGraph *graph = (CompactGraph *) malloc(sizeof(CompactGraph));
+    graph->verticesNumber = length;
+    graph->offsets = offsets;
+    graph->bytes = (unsigned char *) realloc(bytes, size + 1);
+    return graph;
+}
+
+/**
+ * @brief Destroys the given graph and all its arrays.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The graph to be destroyed.
+ */
+void CompactGraph_destroy(CompactGraph *graph) {
+    free(graph->offsets);
+    free(graph->bytes);
+    free(graph);
+}
+
+/**
+ * @brief Getter for the graph vertices number.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The graph.
+ * @return int The vertices number of the CSR graph it was created from.
+ */
+int CompactGraph_getVerticesNumber(CompactGraph *graph) {
+    return graph->verticesNumber;
+}
+
+/**
+ * @brief Getter for the size of the encoded neighbors, without the offsets.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The graph.
+ * @return unsigned int The amount of encoded bytes.
+ */
+unsigned int CompactGraph_getBytesNumber(CompactGraph *graph) {
+    return graph->offsets[graph->verticesNumber];
+}
+
+/**
+ * @brief Places the iterator before the first neighbor of the given vertex.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The graph.
+ * @param vertex The vertex index.
+ * @param iterator The iterator to be placed.
+ */
+void CompactGraph_iterate(CompactGraph *graph, int vertex,
+    CompactIterator *iterator) {
+    iterator->position = graph->bytes + graph->offsets[vertex];
+    iterator->end = graph->bytes + graph->offsets[vertex + 1];
+    iterator->previous = vertex;
+    iterator->first = 1;
+}
+
+/**
+ * @brief Decodes the next neighbor of the iterator vertex. The neighbors come
+ * on increasing index order.
+ *
+ * Complexity: O(1).
+ *
+ * @param iterator The iterator, placed by CompactGraph_iterate.
+ * @param neighbor Receives the neighbor index.
+ * @return int 1 if a neighbor was decoded, 0 if there are no more neighbors.
+ */
+int CompactGraph_nextNeighbor(CompactIterator *iterator, int *neighbor) {
+    const unsigned char *position = iterator->position;
+    unsigned int gap = 0;
+    int shift = 0;
+
+    if (position == iterator->end) {
+        return 0;
+    }
+    while (*position & 0x80) {
+        gap |= (unsigned int) (*position++ & 0x7F) << shift;
+        shift += 7;
+    }
+    gap |= (unsigned int) *position++ << shift;
+
+    if (iterator->first) {
+        gap = (gap >> 1) ^ -(gap & 1);
+        iterator->first = 0;
+    }
+    iterator->previous += (int) gap;
+    iterator->position = position;
+    *neighbor = iterator->previous;
+    return 1;
+}
@@ -0,0 +1,37 @@
+#include "csr_graph.h"
+
+#ifndef COMPACT_GRAPH_H
+#define COMPACT_GRAPH_H
+
+typedef struct compact_graph CompactGraph;
+
+/**
+ * @brief Cursor over the encoded neighbors of a vertex. It is declared here,
+ * and not hidden like the graphs, so it can live on the caller's stack.
+ */
+struct compact_iterator {
+    /** Next byte to be decoded. */
+    const unsigned char *position;
+    /** First byte after the vertex neighbors. */
+    const unsigned char *end;
+    /** Last decoded neighbor, or the vertex itself before the first one. */
+    int previous;
+    /** If 1, the next gap is the signed one of the first neighbor. */
+    int first;
+};
+typedef struct compact_iterator CompactIterator;
+
+CompactGraph * CompactGraph_createFromCsr(CsrGraph *csr);
+
+void CompactGraph_destroy(CompactGraph *graph);
+
+int CompactGraph_getVerticesNumber(CompactGraph *graph);
+
+unsigned int CompactGraph_getBytesNumber(CompactGraph *graph);
+
+void CompactGraph_iterate(CompactGraph *graph, int vertex,
+    CompactIterator *iterator);
+
+int CompactGraph_nextNeighbor(CompactIterator *iterator, int *neighbor);
+
+#endif
@@ -0,0 +1,264 @@
+#include <stdlib.h>
+#include "csr_graph.h"
+
+/**
+ * @brief Initial capacity of the pending edges buffer.
+ */
+#define CSR_INITIAL_EDGES_CAPACITY 1024
+
+/**
+ * @brief CsrGraph structure.
+ *
+ * Graph stored on the compressed sparse row format. The neighbors of the
+ * vertex "v" are stored contiguously on neighbors[offsets[v]] until
+ * neighbors[offsets[v + 1] - 1]. Vertices are referenced by their integer
+ * index, so no allocation is made per vertex or per edge.
+ *
+ * While the graph is being loaded, the edges are appended to a pending buffer.
+ * The CSR arrays are only available after calling CsrGraph_build.
+ */
+struct csr_graph {
+    /** The amount of vertices. */
+    int verticesNumber;
+    /** Array with verticesNumber + 1 positions delimiting each neighborhood. */
+    int *offsets;
+    /** Array with the neighbors of all vertices, grouped by vertex. */
+    int *neighbors;
+    /** Origin of each pending edge endpoint. */
+    int *pendingSources;
+    /** Target of each pending edge endpoint. */
+    int *pendingTargets;
+    /** Amount of pending edge endpoints. */
+    int pendingSize;
+    /** Allocated length of the pending arrays. */
+    int pendingCapacity;
+    /** If 0, the CSR arrays belong to someone else and are not released. */
+    int ownsArrays;
+};
+
+/**
+ * @brief Creates a new CSR graph with the given amount of vertices and no
+ * edges.
+ *
+ * Complexity: O(1).
+ *
+ * @param verticesNumber The amount of vertices.
+ * @return CsrGraph* A pointer to the created graph.
+ */
+CsrGraph * CsrGraph_create(int verticesNumber) {
+    CsrGraph *graph = (CsrGraph *) malloc(sizeof(CsrGraph));
+    graph->verticesNumber = verticesNumber;
+    graph->offsets = NULL;
+    graph->neighbors = NULL;
+    graph->pendingSources = NULL;
+    graph->pendingTargets = NULL;
+    graph->pendingSize = 0;
+    graph->pendingCapacity = 0;
+    graph->ownsArrays = 1;
+    return graph;
+}
+
+/**
+ * @brief Creates a built CSR graph from arrays filled by the caller.
+ *
+ * Complexity: O(1).
+ *
+ * @param verticesNumber The amount of vertices.
+ * @param offsets Array with verticesNumber + 1 positions delimiting each
+ * neighborhood. The graph takes its ownership.
+ * @param neighbors Array with the neighbors of all vertices, grouped by
+ * vertex. The graph takes its ownership.
+ * @return CsrGraph* A pointer to the created graph.
+ */
+CsrGraph * CsrGraph_createFromArrays(int verticesNumber, int *offsets,
+    int *neighbors) {
+    CsrGraph *graph = CsrGraph_create(verticesNumber);
+    graph->offsets = offsets;
+    graph->neighbors = neighbors;
+    return graph;
+}
+
+/**
+ * @brief Creates a built CSR graph over arrays owned by the caller, such as a
+ * mapped snapshot. The arrays are not released with the graph.
+ *
+ * Complexity: O(1).
+ *
+ * @param verticesNumber The amount of vertices.
+ * @param offsets Array with verticesNumber + 1 positions delimiting each
+ * neighborhood.
+ * @param neighbors Array with the neighbors of all vertices, grouped by
+ * vertex.
+ * @return CsrGraph* A pointer to the created graph.
+ */
+CsrGraph * CsrGraph_createView(int verticesNumber, int *offsets,
+    int *neighbors) {
+    CsrGraph *graph = CsrGraph_createFromArrays(verticesNumber, offsets,
+        neighbors);
+    graph->ownsArrays = 0;
+    return graph;
+}
+
+/**
+ * @brief Getter for the amount of neighbor entries of the built graph. Each
+ * undirected edge has two entries.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The built graph.
+ * @return int The length of the neighbors array.
+ */
+int CsrGraph_getNeighborsNumber(CsrGraph *graph) {
+    return graph->offsets[graph->verticesNumber];
+}
+
+/**
+ * @brief Destroys the given graph and all its arrays.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The graph to be destroyed.
+ */
+void CsrGraph_destroy(CsrGraph *graph) {
+    if (graph->ownsArrays) {
+        free(graph->offsets);
+        free(graph->neighbors);
+    }
+    free(graph->pendingSources);
+    free(graph->pendingTargets);
+    free(graph);
+}
+
+/**
+ * @brief Getter for the graph vertices number.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The graph.
+ * @return int The vertices number defined on the creation.
+ */
+int CsrGraph_getVerticesNumber(CsrGraph *graph) {
+    return graph->verticesNumber;
+}
+
+/**
+ * @brief Appends an edge endpoint to the pending buffer, doubling it when
+ * needed.
+ *
+ * Complexity: O(1) amortized.
+ *
+ * @param graph The graph.
+ * @param source The origin vertex index.
+ * @param target The target vertex index.
+ */
+static void CsrGraph_appendPending(CsrGraph *graph, int source, int target) {
+    if (graph->pendingSize == graph->pendingCapacity) {
+        graph->pendingCapacity = graph->pendingCapacity == 0 ?
+            CSR_INITIAL_EDGES_CAPACITY : graph->pendingCapacity * 2;
+        graph->pendingSources = (int *) realloc(graph->pendingSources,
+            graph->pendingCapacity * sizeof(int));
+        graph->pendingTargets = (int *) realloc(graph->pendingTargets,
+            graph->pendingCapacity * sizeof(int));
+    }
+
+    graph->pendingSources[graph->pendingSize] = source;
+    graph->pendingTargets[graph->pendingSize] = target;
+    graph->pendingSize += 1;
+}
+
+/**
+ * @brief Sets an edge between the given vertices.
+ *
+ * The edge is only visible after CsrGraph_build is called.
+ *
+ * Complexity: O(1) amortized.
+ *
+ * @param graph The graph.
+ * @param vertex1 The origin vertex index.
+ * @param vertex2 The target vertex index.
+ * @param oriented If 0, it will also add an edge between vertex2 and vertex1.
+ */
+void CsrGraph_insertEdge(CsrGraph *graph, int vertex1, int vertex2,
+    int oriented) {
+    CsrGraph_appendPending(graph, vertex1, vertex2);
+
+    if (!oriented) {
+        CsrGraph_appendPending(graph, vertex2, vertex1);
+    }
+}
+
+/**
+ * @brief Builds the CSR arrays from the pending edges.
+ *
+ * It counts the degree of each vertex, turns the counts into offsets with a
+ * prefix sum and then scatters the targets on their vertex slots. The pending
+ * buffer is released afterwards. Edges inserted after the build are discarded
+ * by a new build, so all edges must be inserted before it.
+ *
+ * V: The graph's vertices number.
+ * E: The amount of edge endpoints inserted.
+ * Complexity: O(V+E).
+ *
+ * @param graph The graph.
+ */
+void CsrGraph_build(CsrGraph *graph) {
+    int i;
+    int *offsets = (int *) calloc(graph->verticesNumber + 1, sizeof(int));
+    int *neighbors = (int *) malloc((graph->pendingSize + 1) * sizeof(int));
+
+    for (i = 0; i < graph->pendingSize; i += 1) {
+        offsets[graph->pendingSources[i] + 1] += 1;
+    }
+
+    for (i = 0; i < graph->verticesNumber; i += 1) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    // The offsets are used as insertion cursors and then shifted back.
+    for (i = 0; i < graph->pendingSize; i += 1) {
+        neighbors[offsets[graph->pendingSources[i]]++] =
+            graph->pendingTargets[i];
+    }
+
+    for (i = graph->verticesNumber; i > 0; i -= 1) {
+        offsets[i] = offsets[i - 1];
+    }
+    offsets[0] = 0;
+
+    free(graph->offsets);
+    free(graph->neighbors);
+    free(graph->pendingSources);
+    free(graph->pendingTargets);
+    graph->offsets = offsets;
+    graph->neighbors = neighbors;
+    graph->pendingSources = NULL;
+    graph->pendingTargets = NULL;
+    graph->pendingSize = 0;
+    graph->pendingCapacity = 0;
+}
+
+/**
+ * @brief Getter for the amount of neighbors of the given vertex.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The built graph.
+ * @param vertex The vertex index.
+ * @return int The vertex degree.
+ */
+int CsrGraph_getDegree(CsrGraph *graph, int vertex) {
+    return graph->offsets[vertex + 1] - graph->offsets[vertex];
+}
+
+/**
+ * @brief Getter for the neighbors of the given vertex.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The built graph.
+ * @param vertex The vertex index.
+ * @return int* Pointer to the first of CsrGraph_getDegree neighbor indices.
+ */
+int * CsrGraph_getNeighbors(CsrGraph *graph, int vertex) {
+    return graph->neighbors + graph->offsets[vertex];
+}
@@ -0,0 +1,29 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+typedef struct csr_graph CsrGraph;
+
+CsrGraph * CsrGraph_create(int verticesNumber);
+
+CsrGraph * CsrGraph_createFromArrays(int verticesNumber, int *offsets,
+    int *neighbors);
+
+CsrGraph * CsrGraph_createView(int verticesNumber, int *offsets,
+    int *neighbors);
+
+int CsrGraph_getNeighborsNumber(CsrGraph *graph);
+
+void CsrGraph_destroy(CsrGraph *graph);
+
+int CsrGraph_getVerticesNumber(CsrGraph *graph);
+
+void CsrGraph_insertEdge(CsrGraph *graph, int vertex1, int vertex2,
+    int oriented);
+
+void CsrGraph_build(CsrGraph *graph);
+
+int CsrGraph_getDegree(CsrGraph *graph, int vertex);
+
+int * CsrGraph_getNeighbors(CsrGraph *graph, int vertex);
+
+#endif
@@ -0,0 +1,425 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "external_graph.h"
+#include "parallel_bfs.h"
+
+/**
+ * @brief Amount of edges moved by each read or write of a partition file.
+ */
+#define EXTERNAL_GRAPH_BLOCK_EDGES (1 << 16)
+
+/**
+ * @brief Directed edge, as stored on the partition files.
+ */
+struct external_edge {
+    /** The vertex the edge leaves. */
+    int32_t from;
+    /** The vertex the edge reaches. */
+    int32_t to;
+};
+typedef struct external_edge ExternalEdge;
+
+/**
+ * @brief External graph structure.
+ *
+ * The edges are kept on disk, split into partitions by ranges of the vertex
+ * they leave, and only bitmaps with one bit per vertex are kept on memory.
+ * Each partition is a file of ExternalEdge records, always read and written
+ * sequentially in blocks, so a search costs sequential passes over the
+ * partitions that hold frontier vertices instead of random reads.
+ */
+struct external_graph {
+    /** The graph's vertices number. */
+    int verticesNumber;
+    /** The amount of partitions. */
+    int partitionsNumber;
+    /** Amount of consecutive vertices on each partition. */
+    int partitionLength;
+    /** Path of each partition file. */
+    char **paths;
+    /** Open file of each partition. */
+    FILE **files;
+    /** Edges waiting to be written, EXTERNAL_GRAPH_BLOCK_EDGES per
+     * partition. */
+    ExternalEdge *pending;
+    /** Amount of edges waiting on each partition. */
+    int *pendingNumber;
+    /** Amount of edges stored on each partition. */
+    long long *edgesNumber;
+    /** Buffer of the partition reads. */
+    ExternalEdge *block;
+    /** Bitmap of the reached vertices whose partition was not scanned since
+     * they were reached. */
+    unsigned long long *frontier;
+    /** Amount of frontier vertices on each partition. */
+    int *frontierCounts;
+    /** Bytes written on the partition files. */
+    long long bytesWritten;
+    /** Bytes read from the partition files. */
+    long long bytesRead;
+    /** Amount of partition files scanned by the searches. */
+    long long partitionScans;
+    /** If 0, some write failed. */
+    int valid;
+};
+
+/**
+ * @brief Creates an external graph with no edges, creating one empty file per
+ * partition on the directory.
+ *
+ * V: The graph's vertices number.
+ * P: The amount of partitions.
+ * Complexity: O(V/64+P).
+ *
+ * @param directory Existing directory that receives the partition files.
+ * @param verticesNumber The graph's vertices number.
+ * @param partitions The amount of partitions. Less partitions mean less
+ * files scanned per level, more mean less edges read per scan.
+ * @return ExternalGraph* A pointer to the created graph. NULL if a file could
+ * not be created.
+ */
+ExternalGraph * ExternalGraph_create(const char *directory,
+    int verticesNumber, int partitions) {
+    ExternalGraph *graph = (ExternalGraph *) malloc(sizeof(ExternalGraph));
+    int i;
+
+    if (partitions < 1) {
+        partitions = 1;
+    }
+    graph->verticesNumber = verticesNumber;
+    // Whole bitmap words per partition, so its frontier is cleared at once.
+    graph->partitionLength = (verticesNumber / partitions + 64) / 64 * 64;
+    graph->partitionsNumber = partitions;
+    graph->paths = (char **) calloc(partitions, sizeof(char *));
+    graph->files = (FILE **) calloc(partitions, sizeof(FILE *));
+    graph->pending = (ExternalEdge *) malloc((size_t) partitions *
+        EXTERNAL_GRAPH_BLOCK_EDGES * sizeof(ExternalEdge));
+    graph->pendingNumber = (int *) calloc(partitions, sizeof(int));
+    graph->edgesNumber = (long long *) calloc(partitions, sizeof(long long));
+    graph->block = (ExternalEdge *) malloc(EXTERNAL_GRAPH_BLOCK_EDGES *
+        sizeof(ExternalEdge));
+    graph->frontier = (unsigned long long *) calloc(
+        PARALLEL_BFS_WORDS(verticesNumber) + 1, sizeof(unsigned long long));
+    graph->frontierCounts = (int *) calloc(partitions, sizeof(int));
+    graph->bytesWritten = 0;
+    graph->bytesRead = 0;
+    graph->partitionScans = 0;
+    graph->valid = 1;
+
+    for (i = 0; i < partitions; i += 1) {
+        size_t length = strlen(directory) + 32;
+        graph->paths[i] = (char *) malloc(length);
+        snprintf(graph->paths[i], length, "%s/partition-%d.edges", directory,
+            i);
+        graph->files[i] = fopen(graph->paths[i], "w+b");
+        if (graph->files[i] == NULL) {
+            ExternalGraph_destroy(graph);
+            return NULL;
+        }
+    }
+
+    return graph;
+}
+
+/**
+ * @brief Destroys the given graph, removing its partition files.
+ *
+ * P: The amount of partitions.
+ * Complexity: O(P).
+ *
+ * @param graph The graph to be destroyed.
+ */
+void ExternalGraph_destroy(ExternalGraph *graph) {
+    for (int i = 0; i < graph->partitionsNumber; i += 1) {
+        if (graph->files[i]) {
+            fclose(graph->files[i]);
+            remove(graph->paths[i]);
+        }
+        free(graph->paths[i]);
+    }
+
+    free(graph->paths);
+    free(graph->files);
+    free(graph->pending);
+    free(graph->pendingNumber);
+    free(graph->edgesNumber);
+    free(graph->block);
+    free(graph->frontier);
+    free(graph->frontierCounts);
+    free(graph);
+}
+
+/**
+ * @brief Writes the edges waiting on the partition to its file.
+ *
+ * n: The amount of waiting edges.
+ * Complexity: O(n).
+ *
+ * @param graph The graph.
+ * @param partition The partition.
+ */
+static void ExternalGraph_flush(ExternalGraph *graph, int partition) {
+    size_t length = graph->pendingNumber[partition];
+    ExternalEdge *edges = graph->pending +
+        (size_t) partition * EXTERNAL_GRAPH_BLOCK_EDGES;
+
+    if (length == 0) {
+        return;
+    }
+    size_t written = fwrite(edges, sizeof(ExternalEdge), length,
+        graph->files[partition]);
+    if (written != length) {
+        graph->valid = 0;
+    }
+    graph->bytesWritten += written * sizeof(ExternalEdge);
+    graph->edgesNumber[partition] += written;
+    graph->pendingNumber[partition] = 0;
+}
+
+/**
+ * @brief Inserts the directed edge from vertex1 to vertex2 on the partition of
+ * vertex1. The edges are written in blocks, so it must be called before
+ * ExternalGraph_build.
+ *
+ * Complexity: O(1) amortized.
+ *
+ * @param graph The graph.
+ * @param vertex1 The vertex the edge leaves.
+ * @param vertex2 The vertex the edge reaches.
+ */
+void ExternalGraph_insertEdge(ExternalGraph *graph, int vertex1, int vertex2) {
+    int partition = vertex1 / graph->partitionLength;
+    ExternalEdge *edge = graph->pending +
+        (size_t) partition * EXTERNAL_GRAPH_BLOCK_EDGES +
+        graph->pendingNumber[partition];
+
+    edge->from = vertex1;
+    edge->to = vertex2;
+    graph->pendingNumber[partition] += 1;
+    if (graph->pendingNumber[partition] == EXTERNAL_GRAPH_BLOCK_EDGES) {
+        ExternalGraph_flush(graph, partition);
+    }
+}
+
+/**
+ * @brief Writes the waiting edges and releases the write buffers, so the
+ * graph can be searched.
+ *
+ * P: The amount of partitions.
+ * Complexity: O(P*EXTERNAL_GRAPH_BLOCK_EDGES).
+ *
+ * @param graph The graph.
+ * @return int 1 on success, 0 if some write failed.
+ */
+int ExternalGraph_build(ExternalGraph *graph) {
+    for (int i = 0; i < graph->partitionsNumber; i += 1) {
+        ExternalGraph_flush(graph, i);
+        if (fflush(graph->files[i]) != 0) {
+            graph->valid = 0;
+        }
+    }
+
+    free(graph->pending);
+    graph->pending = NULL;
+    return graph->valid;
+}
+
+/**
+ * @brief Sets the vertex on the bitmap if it was not set.
+ *
+ * Complexity: O(1).
+ *
+ * @return int 1 if the vertex was set now, 0 if it already was.
+ */
+static int ExternalGraph_mark(unsigned long long *bitmap, int vertex) {
+    unsigned long long bit = 1ULL << (vertex % 64);
+    if (bitmap[vertex / 64] & bit) {
+        return 0;
+    }
+    bitmap[vertex / 64] |= bit;
+    return 1;
+}
+
+/**
+ * @brief Reads the whole partition, sequentially in blocks, expanding the
+ * edges that leave frontier vertices.
+ *
+ * The reached vertices join the frontier. A vertex reached on this same
+ * partition is expanded by the rest of the scan, but its edges already read
+ * are not, so the caller scans the partition again while it reaches vertices
+ * on it. The blocks are read forward or backward, so the rescans alternate
+ * the direction and a path that goes either way on the file is followed on
+ * few scans.
+ *
+ * n: The amount of edges on the partition.
+ * Complexity: O(n).
+ *
+ * @param graph The graph.
+ * @param partition The partition.
+ * @param eligible Flag per vertex, 1 if the search can expand through it.
+ * @param visited The search visited bitmap.
+ * @param backward If 1, the edges are read from the last to the first.
+ * @param local Receives the amount of vertices reached on the partition.
+ * @return int The amount of vertices reached, or -1 if a read failed.
+ */
+static int ExternalGraph_scan(ExternalGraph *graph, int partition,
+    const unsigned char *eligible, unsigned long long *visited, int backward,
+    int *local) {
+    FILE *file = graph->files[partition];
+    long long edges = graph->edgesNumber[partition];
+    long long blocks = (edges + EXTERNAL_GRAPH_BLOCK_EDGES - 1) /
+        EXTERNAL_GRAPH_BLOCK_EDGES;
+    int reached = 0;
+
+    *local = 0;
+    graph->partitionScans += 1;
+    for (long long b = 0; b < blocks; b += 1) {
+        long long first = (backward ? blocks - 1 - b : b) *
+            EXTERNAL_GRAPH_BLOCK_EDGES;
+        size_t length = edges - first < EXTERNAL_GRAPH_BLOCK_EDGES ?
+            (size_t) (edges - first) : EXTERNAL_GRAPH_BLOCK_EDGES;
+
+        // A short read is an error too: the edges amount is known.
+        if (fseek(file, first * (long long) sizeof(ExternalEdge),
+            SEEK_SET) != 0 || fread(graph->block, sizeof(ExternalEdge),
+            length, file) != length) {
+            return -1;
+        }
+        graph->bytesRead += length * sizeof(ExternalEdge);
+
+        for (size_t k = 0; k < length; k += 1) {
+            size_t i = backward ? length - 1 - k : k;
+            int from = graph->block[i].from;
+            int to = graph->block[i].to;
+            if (!((graph->frontier[from / 64] >> (from % 64)) & 1) ||
+                !eligible[to] || !ExternalGraph_mark(visited, to)) {
+                continue;
+            }
+
+            int toPartition = to / graph->partitionLength;
+            ExternalGraph_mark(graph->frontier, to);
+            graph->frontierCounts[toPartition] += 1;
+            if (toPartition == partition) {
+                *local += 1;
+            }
+            reached += 1;
+        }
+    }
+
+    return reached;
+}
+
+/**
+ * @brief Semi-external breadth first search.
+ *
+ * It searches from the start vertex expanding only through the eligible
+ * vertices, like ParallelBfs_run, and counts how many eligible vertices were
+ * reached. The visited and frontier bitmaps are on memory and the edges on
+ * disk. The partitions are visited in a circular order, starting at the one
+ * of the start vertex, and only the ones holding frontier vertices are read:
+ * each is scanned until it reaches no more vertices on itself, and then its
+ * frontier is cleared. The vertices reached on other partitions are expanded
+ * when the circular order gets to them, so the search goes over several
+ * levels per lap and ends when no partition holds frontier vertices.
+ *
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * S: The amount of partition scans.
+ * Complexity: O(V/64+S*E/P) time. A path that stays on a partition costs a
+ * few scans of it, and a step to another partition costs at most one lap.
+ *
+ * @param graph The built graph.
+ * @param eligible Flag per vertex, 1 if the search can expand through it.
+ * @param start The start vertex index.
+ * @param visited Zeroed bitmap with PARALLEL_BFS_WORDS(V) words. It receives
+ * the reached vertices.
+ * @return int The amount of vertices reached, 0 if the start is not
+ * eligible, or -1 if a partition could not be read.
+ */
+int ExternalGraph_search(ExternalGraph *graph, const unsigned char *eligible,
+    int start, unsigned long long *visited) {
+    size_t bytes = PARALLEL_BFS_WORDS(graph->verticesNumber) *
+        sizeof(unsigned long long);
+    int words = graph->partitionLength / 64;
+    int total = PARALLEL_BFS_WORDS(graph->verticesNumber);
+    int partition = start / graph->partitionLength;
+    int counter = 1, pending = 1;
+
+    if (!eligible[start]) {
+        return 0;
+    }
+
+    memset(graph->frontier, 0, bytes);
+    memset(graph->frontierCounts, 0,
+        graph->partitionsNumber * sizeof(int));
+    ExternalGraph_mark(visited, start);
+    ExternalGraph_mark(graph->frontier, start);
+    graph->frontierCounts[partition] = 1;
+
+    while (pending > 0) {
+        if (graph->frontierCounts[partition] > 0) {
+            int backward = 0, local;
+            do {
+                int reached = ExternalGraph_scan(graph, partition, eligible,
+                    visited, backward, &local);
+                if (reached < 0) {
+                    return -1;
+                }
+                counter += reached;
+                pending += reached;
+                backward = !backward;
+            } while (local > 0);
+
+            // Every frontier vertex of the partition is expanded now.
+            int first = partition * words;
+            int last = first + words < total ? first + words : total;
+            if (last > first) {
+                memset(graph->frontier + first, 0,
+                    (last - first) * sizeof(unsigned long long));
+            }
+            pending -= graph->frontierCounts[partition];
+            graph->frontierCounts[partition] = 0;
+        }
+        partition = (partition + 1) % graph->partitionsNumber;
+    }
+
+    return counter;
+}
+
+/**
+ * @brief Getter for the bytes written on the partition files.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The graph.
+ * @return long long The bytes written.
+ */
+long long ExternalGraph_getBytesWritten(ExternalGraph *graph) {
+    return graph->bytesWritten;
+}
+
+/**
+ * @brief Getter for the bytes read from the partition files by the searches.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The graph.
+ * @return long long The bytes read.
+ */
+long long ExternalGraph_getBytesRead(ExternalGraph *graph) {
+    return graph->bytesRead;
+}
+
+/**
+ * @brief Getter for the amount of partition files scanned by the searches.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The graph.
+ * @return long long The amount of scans.
+ */
+long long ExternalGraph_getPartitionScans(ExternalGraph *graph) {
+    return graph->partitionScans;
+}
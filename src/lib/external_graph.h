@@ -0,0 +1,27 @@
+#ifndef EXTERNAL_GRAPH_H
+#define EXTERNAL_GRAPH_H
+
+/** Default amount of edge partitions written on disk. */
+#define EXTERNAL_GRAPH_PARTITIONS 16
+
+typedef struct external_graph ExternalGraph;
+
+ExternalGraph * ExternalGraph_create(const char *directory,
+    int verticesNumber, int partitions);
+
+void ExternalGraph_destroy(ExternalGraph *graph);
+
+void ExternalGraph_insertEdge(ExternalGraph *graph, int vertex1, int vertex2);
+
+int ExternalGraph_build(ExternalGraph *graph);
+
+int ExternalGraph_search(ExternalGraph *graph, const unsigned char *eligible,
+    int start, unsigned long long *visited);
+
+long long ExternalGraph_getBytesWritten(ExternalGraph *graph);
+
+long long ExternalGraph_getBytesRead(ExternalGraph *graph);
+
+long long ExternalGraph_getPartitionScans(ExternalGraph *graph);
+
+#endif
@@ -0,0 +1,135 @@
+#include <stdlib.h>
+#include "frontier.h"
+
+/**
+ * @brief Initial capacity of a frontier. Must be a power of two.
+ */
+#define FRONTIER_INITIAL_CAPACITY 64
+
+/**
+ * @brief Frontier structure.
+ *
+ * Growable circular buffer used by the iterative traversals to store the
+ * items that were discovered but not expanded yet. Items can be removed from
+ * both ends, so the same structure works as a queue (breadth first search) and
+ * as a stack (depth first search).
+ */
+struct frontier {
+    /** The circular buffer. */
+    void **items;
+    /** Position of the first item on the buffer. */
+    int first;
+    /** Amount of items stored. */
+    int size;
+    /** Allocated length of the buffer. Always a power of two. */
+    int capacity;
+};
+
+/**
+ * @brief Creates an empty frontier.
+ *
+ * Complexity: O(1).
+ *
+ * @return Frontier* A pointer to the created frontier.
+ */
+Frontier * Frontier_create() {
+    Frontier *frontier = (Frontier *) malloc(sizeof(Frontier));
+    frontier->items = (void **) malloc(FRONTIER_INITIAL_CAPACITY *
+        sizeof(void *));
+    frontier->first = 0;
+    frontier->size = 0;
+    frontier->capacity = FRONTIER_INITIAL_CAPACITY;
+    return frontier;
+}
+
+/**
+ * @brief Destroys the given frontier. The stored items are not destroyed.
+ *
+ * Complexity: O(1).
+ *
+ * @param frontier The frontier to be destroyed.
+ */
+void Frontier_destroy(Frontier *frontier) {
+    free(frontier->items);
+    free(frontier);
+}
+
+/**
+ * @brief Getter for the frontier size.
+ *
+ * Complexity: O(1).
+ *
+ * @param frontier The frontier.
+ * @return int The amount of items stored.
+ */
+int Frontier_getSize(Frontier *frontier) {
+    return frontier->size;
+}
+
+/**
+ * @brief Inserts an item at the end of the frontier.
+ *
+ * When the buffer is full, its capacity is doubled and the items are moved
+ * so they start at the beginning of the new buffer.
+ *
+ * n: The frontier size.
+ * Complexity: O(1) amortized, O(n) when the buffer grows.
+ *
+ * @param frontier The frontier.
+ * @param data The item.
+ */
+void Frontier_push(Frontier *frontier, void *data) {
+    if (frontier->size == frontier->capacity) {
+        void **items = (void **) malloc(frontier->capacity * 2 *
+            sizeof(void *));
+        for (int i = 0; i < frontier->size; i += 1) {
+            items[i] = frontier->items[
+                (frontier->first + i) & (frontier->capacity - 1)];
+        }
+        free(frontier->items);
+        frontier->items = items;
+        frontier->first = 0;
+        frontier->capacity *= 2;
+    }
+
+    frontier->items[(frontier->first + frontier->size) &
+        (frontier->capacity - 1)] = data;
+    frontier->size += 1;
+}
+
+/**
+ * @brief Removes the first item of the frontier, using it as a queue.
+ *
+ * Complexity: O(1).
+ *
+ * @param frontier The frontier.
+ * @return void* The removed item. NULL if the frontier is empty.
+ */
+void * Frontier_popFirst(Frontier *frontier) {
+    if (frontier->size == 0) {
+        return NULL;
+    }
+
+    void *data = frontier->items[frontier->first];
+    frontier->first = (frontier->first + 1) & (frontier->capacity - 1);
+    frontier->size -= 1;
+    return data;
+}
+
+/**
+ * @brief Removes the last item of the frontier, using it as a stack.
+ *
+ * Complexity: O(1).
+ *
+ * @param frontier The frontier.
+ * @return void* The removed item. NULL if the frontier is empty.
+ */
+void * Frontier_popLast(Frontier *frontier) {
+    if (frontier->size == 0) {
+        return NULL;
+    }
+
+    frontier->size -= 1;
+    return frontier->items[(frontier->first + frontier->size) &
+        (frontier->capacity - 1)];
+}
@@ -0,0 +1,18 @@
+#ifndef FRONTIER_H
+#define FRONTIER_H
+
+typedef struct frontier Frontier;
+
+Frontier * Frontier_create();
+
+void Frontier_destroy(Frontier *frontier);
+
+int Frontier_getSize(Frontier *frontier);
+
+void Frontier_push(Frontier *frontier, void *data);
+
+void * Frontier_popFirst(Frontier *frontier);
+
+void * Frontier_popLast(Frontier *frontier);
+
+#endif
@@ -1,6 +1,10 @@
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include "graph.h"
 #include "list.h"
+#include "arena.h"
+#include "hash.h"
 
 /**
  * @brief Vertex structure.
@@ -27,6 +31,25 @@ Vertex * Vertex_create(void *data) {
     return vertex;
 }
 
+/**
+ * @brief Creates a new vertex with the given data on the given arena.
+ * 
+ * The vertex and its edges list are allocated on the arena, and they are
+ * released together with it, so Vertex_destroy must not be called.
+ * 
+ * Complexity: O(1).
+ * 
+ * @param arena The arena.
+ * @param data An generic pointer to the data the will be stored on the vertex.
+ * @return Vertex* A pointer to the new vertex.
+ */
+Vertex * Vertex_createInArena(Arena *arena, void *data) {
+    Vertex *vertex = (Vertex *) Arena_alloc(arena, sizeof(Vertex));
+    vertex->data = data;
+    vertex->edges = List_createInArena(arena);
+    return vertex;
+}
+
 /**
  * @brief Getter for the vertex data.
  * 
@@ -101,13 +124,65 @@ void Vertex_setEdge(Vertex *vertex1, Vertex *vertex2, int oriented) {
     }
 }
 
+/**
+ * @brief Initial capacity of the dinamic graph vertices and edges arrays.
+ */
+#define DINAMIC_GRAPH_INITIAL_CAPACITY 16
+
+/**
+ * @brief Key of the empty slots of the dinamic graph edges table.
+ */
+#define DINAMIC_GRAPH_EMPTY_EDGE UINT64_MAX
+
+/**
+ * @brief Slot of the dinamic graph edges table.
+ */
+struct dinamic_graph_edge {
+    /** Origin vertex on the high 32 bits, target on the low ones. */
+    uint64_t key;
+    /** Position of the target on the origin neighbors array. */
+    int position;
+};
+typedef struct dinamic_graph_edge DinamicGraphEdge;
+
 /**
  * @brief DinamicGraph structure for graphs that dont have an already defined
- * number of vertices. Slower than the fixed graph.
+ * number of vertices, and whose vertices and edges can be removed.
+ *
+ * The vertices are slots referenced by their integer index. Removed slots are
+ * kept on a free list and reused by the next insertions, so the indices of the
+ * other vertices never change. Each vertex has its own growable neighbors
+ * array, and every directed edge is also kept on an open addressing table that
+ * gives its position on that array, so finding and removing an edge costs
+ * O(1) expected: the last neighbor is moved to the removed position.
  */
 struct dinamic_graph {
-    /** List used to store the graph's vertices. */
-    List *vertices;
+    /** Data stored on each vertex slot. */
+    void **data;
+    /** Flag per slot, 1 if the slot holds a vertex. */
+    unsigned char *alive;
+    /** Neighbors array of each slot. */
+    int **neighbors;
+    /** Amount of neighbors of each slot. */
+    int *degrees;
+    /** Allocated length of the neighbors array of each slot. */
+    int *neighborsCapacities;
+    /** Amount of slots ever used. */
+    int slotsNumber;
+    /** Allocated amount of slots. */
+    int slotsCapacity;
+    /** Amount of vertices. */
+    int verticesNumber;
+    /** Removed slots, to be reused. */
+    int *freeSlots;
+    /** Amount of removed slots. */
+    int freeSlotsNumber;
+    /** The directed edges table. Its length is always a power of two. */
+    DinamicGraphEdge *edges;
+    /** Length of the edges table minus one, used to wrap the probing. */
+    unsigned int edgesMask;
+    /** Amount of directed edges. */
+    int edgesNumber;
 };
 
 /**
@@ -119,48 +194,399 @@ struct dinamic_graph {
  */
 DinamicGraph * DinamicGraph_create() {
     DinamicGraph *graph = (DinamicGraph *) malloc(sizeof(DinamicGraph));
-    graph->vertices = List_create();
+    int capacity = DINAMIC_GRAPH_INITIAL_CAPACITY;
+
+    graph->data = (void **) malloc(capacity * sizeof(void *));
+    graph->alive = (unsigned char *) malloc(capacity);
+    graph->neighbors = (int **) malloc(capacity * sizeof(int *));
+    graph->degrees = (int *) malloc(capacity * sizeof(int));
+    graph->neighborsCapacities = (int *) malloc(capacity * sizeof(int));
+    graph->freeSlots = (int *) malloc(capacity * sizeof(int));
+    graph->slotsNumber = 0;
+    graph->slotsCapacity = capacity;
+    graph->verticesNumber = 0;
+    graph->freeSlotsNumber = 0;
+
+    graph->edges = (DinamicGraphEdge *) malloc(capacity *
+        sizeof(DinamicGraphEdge));
+    graph->edgesMask = capacity - 1;
+    graph->edgesNumber = 0;
+    for (int i = 0; i < capacity; i += 1) {
+        graph->edges[i].key = DINAMIC_GRAPH_EMPTY_EDGE;
+    }
+
     return graph;
 }
 
 /**
- * @brief Getter for the graph vertices.
+ * @brief Destroy the given graph.
  * 
- * Complexity: O(1).
+ * It will assume that the data stored on the vertices will be destroyed by
+ * who created it.
+ * 
+ * n: The amount of slots.
+ * Complexity: O(n).
  * 
+ * @param graph The graph to be destroyied.
+ */
+void DinamicGraph_destroy(DinamicGraph *graph) {
+    for (int i = 0; i < graph->slotsNumber; i += 1) {
+        free(graph->neighbors[i]);
+    }
+    free(graph->data);
+    free(graph->alive);
+    free(graph->neighbors);
+    free(graph->degrees);
+    free(graph->neighborsCapacities);
+    free(graph->freeSlots);
+    free(graph->edges);
+    free(graph);
+}
+
+/**
+ * @brief Getter for the amount of vertices slots ever used. Every vertex index
+ * is smaller than it.
+ *
+ * Complexity: O(1).
+ *
  * @param graph The graph.
- * @return List* The graph vertices.
+ * @return int The amount of slots.
  */
-List * DinamicGraph_getVertices(DinamicGraph *graph) {
-    return graph->vertices;
+int DinamicGraph_getSlotsNumber(DinamicGraph *graph) {
+    return graph->slotsNumber;
 }
 
 /**
- * @brief Destroy the given graph.
+ * @brief Getter for the amount of vertices.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The graph.
+ * @return int The amount of vertices.
+ */
+int DinamicGraph_getVerticesNumber(DinamicGraph *graph) {
+    return graph->verticesNumber;
+}
+
+/**
+ * @brief Getter for the amount of undirected edges.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The graph.
+ * @return int The amount of edges. Each self loop counts as half an edge.
+ */
+int DinamicGraph_getEdgesNumber(DinamicGraph *graph) {
+    return graph->edgesNumber / 2;
+}
+
+/**
+ * @brief Checks if the given slot holds a vertex.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The graph.
+ * @param vertex The vertex index.
+ * @return int 1 if the vertex exists, 0 otherwise.
+ */
+int DinamicGraph_hasVertex(DinamicGraph *graph, int vertex) {
+    return vertex >= 0 && vertex < graph->slotsNumber && graph->alive[vertex];
+}
+
+/**
+ * @brief Getter for the data of the given vertex.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The graph.
+ * @param vertex The vertex index.
+ * @return void* The vertex data.
+ */
+void * DinamicGraph_getData(DinamicGraph *graph, int vertex) {
+    return graph->data[vertex];
+}
+
+/**
+ * @brief Inserts a new vertex on the graph, with no edges.
  * 
- * It will destroy only the list that was created. It will assume that the
- * inserted vertices and it's contents will be removed and destroyed by who
- * created them.
+ * Complexity: O(1) amortized.
  * 
+ * @param graph The graph.
+ * @param data The data stored on the vertex.
+ * @return int The vertex index.
+ */
+int DinamicGraph_insertVertex(DinamicGraph *graph, void *data) {
+    int vertex;
+
+    if (graph->freeSlotsNumber > 0) {
+        vertex = graph->freeSlots[--graph->freeSlotsNumber];
+    } else {
+        if (graph->slotsNumber == graph->slotsCapacity) {
+            int capacity = graph->slotsCapacity * 2;
+            graph->data = (void **) realloc(graph->data,
+                capacity * sizeof(void *));
+            graph->alive = (unsigned char *) realloc(graph->alive, capacity);
+            graph->neighbors = (int **) realloc(graph->neighbors,
+                capacity * sizeof(int *));
+            graph->degrees = (int *) realloc(graph->degrees,
+                capacity * sizeof(int));
+            graph->neighborsCapacities = (int *) realloc(
+                graph->neighborsCapacities, capacity * sizeof(int));
+            graph->freeSlots = (int *) realloc(graph->freeSlots,
+                capacity * sizeof(int));
+            graph->slotsCapacity = capacity;
+        }
+        vertex = graph->slotsNumber++;
+        graph->neighbors[vertex] = NULL;
+        graph->neighborsCapacities[vertex] = 0;
+    }
+
+    graph->data[vertex] = data;
+    graph->alive[vertex] = 1;
+    graph->degrees[vertex] = 0;
+    graph->verticesNumber += 1;
+    return vertex;
+}
+
+/**
+ * @brief Calculates the edges table key of the directed edge.
+ */
+static uint64_t DinamicGraph_edgeKey(int vertex1, int vertex2) {
+    return (uint64_t) (unsigned int) vertex1 << 32 | (unsigned int) vertex2;
+}
+
+/**
+ * @brief Calculates the edges table position where the key probing starts.
+ */
+static unsigned int DinamicGraph_edgeHome(DinamicGraph *graph, uint64_t key) {
+    return (unsigned int) ((key * 0x9E3779B97F4A7C15ULL) >> 32) &
+        graph->edgesMask;
+}
+
+/**
+ * @brief Finds the edges table slot of the directed edge.
+ *
+ * Complexity: O(1) expected.
+ *
+ * @param graph The graph.
+ * @param key The edge key.
+ * @return unsigned int The slot holding the key, or the empty slot where it
+ * would be inserted.
+ */
+static unsigned int DinamicGraph_findEdge(DinamicGraph *graph, uint64_t key) {
+    unsigned int position = DinamicGraph_edgeHome(graph, key);
+
+    while (graph->edges[position].key != DINAMIC_GRAPH_EMPTY_EDGE &&
+        graph->edges[position].key != key) {
+        position = (position + 1) & graph->edgesMask;
+    }
+
+    return position;
+}
+
+/**
+ * @brief Doubles the edges table, inserting all the edges again.
+ *
+ * E: The amount of edges.
+ * Complexity: O(E).
+ *
+ * @param graph The graph.
+ */
+static void DinamicGraph_growEdges(DinamicGraph *graph) {
+    DinamicGraphEdge *edges = graph->edges;
+    unsigned int length = graph->edgesMask + 1;
+    unsigned int i;
+
+    graph->edgesMask = length * 2 - 1;
+    graph->edges = (DinamicGraphEdge *) malloc(length * 2 *
+        sizeof(DinamicGraphEdge));
+    for (i = 0; i < length * 2; i += 1) {
+        graph->edges[i].key = DINAMIC_GRAPH_EMPTY_EDGE;
+    }
+
+    for (i = 0; i < length; i += 1) {
+        if (edges[i].key != DINAMIC_GRAPH_EMPTY_EDGE) {
+            graph->edges[DinamicGraph_findEdge(graph, edges[i].key)] = edges[i];
+        }
+    }
+
+    free(edges);
+}
+
+/**
+ * @brief Gives the home slot of the key held by the edges table slot, or -1
+ * if the slot is empty.
+ */
+static long DinamicGraph_edgeSlotHome(void *context, const void *slot) {
+    const DinamicGraphEdge *edge = (const DinamicGraphEdge *) slot;
+    if (edge->key == DINAMIC_GRAPH_EMPTY_EDGE) {
+        return -1;
+    }
+    return DinamicGraph_edgeHome((DinamicGraph *) context, edge->key);
+}
+
+/**
+ * @brief Appends the target to the origin neighbors, registering the directed
+ * edge on the edges table.
+ *
+ * Complexity: O(1) amortized.
+ */
+static void DinamicGraph_appendNeighbor(DinamicGraph *graph, int vertex1,
+    int vertex2) {
+    if (graph->degrees[vertex1] == graph->neighborsCapacities[vertex1]) {
+        graph->neighborsCapacities[vertex1] =
+            graph->neighborsCapacities[vertex1] == 0 ?
+            4 : graph->neighborsCapacities[vertex1] * 2;
+        graph->neighbors[vertex1] = (int *) realloc(graph->neighbors[vertex1],
+            graph->neighborsCapacities[vertex1] * sizeof(int));
+    }
+
+    if ((unsigned int) (graph->edgesNumber + 1) * 2 > graph->edgesMask + 1) {
+        DinamicGraph_growEdges(graph);
+    }
+
+    uint64_t key = DinamicGraph_edgeKey(vertex1, vertex2);
+    unsigned int position = DinamicGraph_findEdge(graph, key);
+    graph->edges[position].key = key;
+    graph->edges[position].position = graph->degrees[vertex1];
+    graph->neighbors[vertex1][graph->degrees[vertex1]++] = vertex2;
+    graph->edgesNumber += 1;
+}
+
+/**
+ * @brief Removes the target from the origin neighbors and the directed edge
+ * from the edges table. The last neighbor takes the removed position.
+ *
+ * Complexity: O(1) expected.
+ */
+static void DinamicGraph_removeNeighbor(DinamicGraph *graph, int vertex1,
+    int vertex2) {
+    unsigned int slot = DinamicGraph_findEdge(graph,
+        DinamicGraph_edgeKey(vertex1, vertex2));
+    int position = graph->edges[slot].position;
+    int last = graph->neighbors[vertex1][--graph->degrees[vertex1]];
+
+    graph->edges[Hash_eraseSlot(graph->edges, sizeof(DinamicGraphEdge),
+        graph->edgesMask, slot, DinamicGraph_edgeSlotHome, graph)].key =
+        DINAMIC_GRAPH_EMPTY_EDGE;
+    graph->edgesNumber -= 1;
+
+    if (last != vertex2) {
+        graph->neighbors[vertex1][position] = last;
+        graph->edges[DinamicGraph_findEdge(graph,
+            DinamicGraph_edgeKey(vertex1, last))].position = position;
+    }
+}
+
+/**
+ * @brief Checks if there is an edge between the given vertices.
+ *
+ * Complexity: O(1) expected.
+ *
+ * @param graph The graph.
+ * @param vertex1 The origin vertex index.
+ * @param vertex2 The target vertex index.
+ * @return int 1 if the edge exists, 0 otherwise.
+ */
+int DinamicGraph_hasEdge(DinamicGraph *graph, int vertex1, int vertex2) {
+    uint64_t key = DinamicGraph_edgeKey(vertex1, vertex2);
+    return graph->edges[DinamicGraph_findEdge(graph, key)].key == key;
+}
+
+/**
+ * @brief Sets an undirected edge between the given vertices. Repeated edges
+ * are ignored.
+ *
+ * Complexity: O(1) amortized.
+ *
+ * @param graph The graph.
+ * @param vertex1 The first vertex index.
+ * @param vertex2 The second vertex index.
+ * @return int 1 if the edge was inserted, 0 if it already existed.
+ */
+int DinamicGraph_insertEdge(DinamicGraph *graph, int vertex1, int vertex2) {
+    if (DinamicGraph_hasEdge(graph, vertex1, vertex2)) {
+        return 0;
+    }
+
+    DinamicGraph_appendNeighbor(graph, vertex1, vertex2);
+    if (vertex1 != vertex2) {
+        DinamicGraph_appendNeighbor(graph, vertex2, vertex1);
+    }
+    return 1;
+}
+
+/**
+ * @brief Removes the undirected edge between the given vertices.
+ *
+ * Complexity: O(1) expected.
+ *
+ * @param graph The graph.
+ * @param vertex1 The first vertex index.
+ * @param vertex2 The second vertex index.
+ * @return int 1 if the edge was removed, 0 if it did not exist.
+ */
+int DinamicGraph_removeEdge(DinamicGraph *graph, int vertex1, int vertex2) {
+    if (!DinamicGraph_hasEdge(graph, vertex1, vertex2)) {
+        return 0;
+    }
+
+    DinamicGraph_removeNeighbor(graph, vertex1, vertex2);
+    if (vertex1 != vertex2) {
+        DinamicGraph_removeNeighbor(graph, vertex2, vertex1);
+    }
+    return 1;
+}
+
+/**
+ * @brief Removes the vertex and all its edges. Its index may be reused by the
+ * next inserted vertex.
+ *
+ * d: The vertex degree.
+ * Complexity: O(d) expected.
+ *
+ * @param graph The graph.
+ * @param vertex The vertex index.
+ * @return void* The data stored on the removed vertex.
+ */
+void * DinamicGraph_removeVertex(DinamicGraph *graph, int vertex) {
+    while (graph->degrees[vertex] > 0) {
+        DinamicGraph_removeEdge(graph, vertex,
+            graph->neighbors[vertex][graph->degrees[vertex] - 1]);
+    }
+
+    graph->alive[vertex] = 0;
+    graph->freeSlots[graph->freeSlotsNumber++] = vertex;
+    graph->verticesNumber -= 1;
+    return graph->data[vertex];
+}
+
+/**
+ * @brief Getter for the amount of neighbors of the given vertex.
+ *
  * Complexity: O(1).
- * 
- * @param graph The graph to be destroyied.
+ *
+ * @param graph The graph.
+ * @param vertex The vertex index.
+ * @return int The vertex degree.
  */
-void DinamicGraph_destroy(DinamicGraph *graph) {
-    List_destroy(DinamicGraph_getVertices(graph));
-    free(graph);
+int DinamicGraph_getDegree(DinamicGraph *graph, int vertex) {
+    return graph->degrees[vertex];
 }
 
 /**
- * @brief Inserts a new vertex on the graph.
- * 
+ * @brief Getter for the neighbors of the given vertex. The array is only valid
+ * until the next change on the graph.
+ *
  * Complexity: O(1).
- * 
+ *
  * @param graph The graph.
- * @param vertex The vertex to be inserted.
+ * @param vertex The vertex index.
+ * @return int* Pointer to the first of DinamicGraph_getDegree neighbor
+ * indices.
  */
-void DinamicGraph_insertVertex(DinamicGraph *graph, Vertex *vertex) {
-    List_insertItem(DinamicGraph_getVertices(graph), vertex, -1);
+int * DinamicGraph_getNeighbors(DinamicGraph *graph, int vertex) {
+    return graph->neighbors[vertex];
 }
 
 /**
@@ -174,16 +600,16 @@ struct graph {
 };
 
 /**
- * @brief Creates a new graph
+ * @brief Creates a new graph, with every vertex empty until it is inserted.
  * 
- * Complexity: O(1).
+ * Complexity: O(V), being V = "verticesNumber".
  *
  * @param verticesNumber The amount of vertices.
  * @return Graph* A pointer to the created graph.
  */
 Graph * Graph_create(int verticesNumber) {
     Graph *graph = (Graph *) malloc(sizeof(Graph));
-    graph->vertices = (Vertex **) malloc(verticesNumber * sizeof(Vertex *));
+    graph->vertices = (Vertex **) calloc(verticesNumber, sizeof(Vertex *));
     graph->verticesNumber = verticesNumber;
     return graph;
 }
@@ -238,4 +664,27 @@ void Graph_destroy(Graph *graph) {
 void Graph_insertVertex(Graph *graph, Vertex *vertex, int position) {
     Vertex **vertices = Graph_getVertices(graph);
     vertices[position] = vertex;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Moves the vertices to the given order, so the vertex order[i]
+ * becomes the vertex i.
+ *
+ * n: The graph's vertices number.
+ * Complexity: O(n).
+ *
+ * @param graph The graph.
+ * @param order The old index of each new position.
+ */
+void Graph_permuteVertices(Graph *graph, const int *order) {
+    int length = Graph_getVerticesNumber(graph);
+    Vertex **vertices = Graph_getVertices(graph);
+    Vertex **copy = (Vertex **) malloc((length + 1) * sizeof(Vertex *));
+
+    memcpy(copy, vertices, length * sizeof(Vertex *));
+    for (int i = 0; i < length; i += 1) {
+        Graph_insertVertex(graph, copy[order[i]], i);
+    }
+
+    free(copy);
+}
@@ -1,4 +1,5 @@
 #include "list.h"
+#include "arena.h"
 
 #ifndef GRAPH_H
 #define GRAPH_H
@@ -7,6 +8,8 @@ typedef struct vertex Vertex;
 
 Vertex * Vertex_create(void *data);
 
+Vertex * Vertex_createInArena(Arena *arena, void *data);
+
 void * Vertex_getData(Vertex *vertex);
 
 void Vertex_setData(Vertex *vertex, void *data);
@@ -22,11 +25,31 @@ typedef struct dinamic_graph DinamicGraph;
 
 DinamicGraph * DinamicGraph_create();
 
-List * DinamicGraph_getVertices(DinamicGraph *graph);
-
 void DinamicGraph_destroy(DinamicGraph *graph);
 
-void DinamicGraph_insertVertex(DinamicGraph *graph, Vertex *vertex);
+int DinamicGraph_getSlotsNumber(DinamicGraph *graph);
+
+int DinamicGraph_getVerticesNumber(DinamicGraph *graph);
+
+int DinamicGraph_getEdgesNumber(DinamicGraph *graph);
+
+int DinamicGraph_hasVertex(DinamicGraph *graph, int vertex);
+
+void * DinamicGraph_getData(DinamicGraph *graph, int vertex);
+
+int DinamicGraph_insertVertex(DinamicGraph *graph, void *data);
+
+void * DinamicGraph_removeVertex(DinamicGraph *graph, int vertex);
+
+int DinamicGraph_hasEdge(DinamicGraph *graph, int vertex1, int vertex2);
+
+int DinamicGraph_insertEdge(DinamicGraph *graph, int vertex1, int vertex2);
+
+int DinamicGraph_removeEdge(DinamicGraph *graph, int vertex1, int vertex2);
+
+int DinamicGraph_getDegree(DinamicGraph *graph, int vertex);
+
+int * DinamicGraph_getNeighbors(DinamicGraph *graph, int vertex);
 
 
 typedef struct graph Graph;
@@ -41,4 +64,6 @@ void Graph_destroy(Graph *graph);
 
 void Graph_insertVertex(Graph *graph, Vertex *vertex, int position);
 
+void Graph_permuteVertices(Graph *graph, const int *order);
+
 #endif
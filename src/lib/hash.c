@@ -0,0 +1,62 @@
+#include <string.h>
+#include "hash.h"
+
+/**
+ * @brief Calculates the FNV-1a hash of the given id.
+ *
+ * n: The id length.
+ * Complexity: O(n).
+ *
+ * @param id The id.
+ * @return unsigned int The id hash.
+ */
+unsigned int Hash_id(const char *id) {
+    unsigned int hash = 2166136261u;
+    for (; *id != '\0'; id++) {
+        hash ^= (unsigned char) *id;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Removes a slot of an open addressing table with linear probing,
+ * moving back the next slots of the probing cluster that can fill its place,
+ * so no tombstone is needed.
+ *
+ * A key can move back only if its home is not between the hole and its
+ * current slot, cyclically.
+ *
+ * Complexity: O(1) expected.
+ *
+ * @param slots The table slots.
+ * @param slotSize The size of each slot.
+ * @param mask The table length minus one. The length is a power of two.
+ * @param position The slot to be emptied.
+ * @param home Gives the home slot of a slot's key, or -1 if it is empty.
+ * @param context Context given to the home function.
+ * @return unsigned int The slot left without a key, which the caller marks
+ * as empty.
+ */
+unsigned int Hash_eraseSlot(void *slots, size_t slotSize, unsigned int mask,
+    unsigned int position, HashSlotHome home, void *context) {
+    char *bytes = (char *) slots;
+    unsigned int next = position;
+
+    while (1) {
+        next = (next + 1) & mask;
+        long nextHome = home(context, bytes + next * slotSize);
+        if (nextHome < 0) {
+            break;
+        }
+
+        if (((next - (unsigned int) nextHome) & mask) >=
+            ((next - position) & mask)) {
+            memcpy(bytes + position * slotSize, bytes + next * slotSize,
+                slotSize);
+            position = next;
+        }
+    }
+
+    return position;
+}
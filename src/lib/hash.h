@@ -0,0 +1,18 @@
+#include <stddef.h>
+
+#ifndef HASH_H
+#define HASH_H
+
+/**
+ * @brief Gives the home slot of the key held by the slot of an open
+ * addressing table, already wrapped by the table mask, or -1 if the slot is
+ * empty.
+ */
+typedef long (*HashSlotHome)(void *context, const void *slot);
+
+unsigned int Hash_id(const char *id);
+
+unsigned int Hash_eraseSlot(void *slots, size_t slotSize, unsigned int mask,
+    unsigned int position, HashSlotHome home, void *context);
+
+#endif
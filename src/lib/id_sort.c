@@ -0,0 +1,380 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "id_sort.h"
+
+/**
+ * @brief Ranges with at most this amount of ids are sorted by insertion.
+ */
+#define ID_SORT_INSERTION_LENGTH 16
+
+/**
+ * @brief Id being sorted.
+ *
+ * The next 8 bytes of the id, from the current depth, are cached as a big
+ * endian word padded with zeros, so most comparisons are a single integer
+ * comparison without following the id pointer. Comparing the words gives the
+ * same result as strcmp on those bytes.
+ */
+struct id_sort_item {
+    /** The cached 8 bytes of the id. */
+    uint64_t prefix;
+    /** The id. */
+    const char *id;
+    /** Position of the id on the unsorted array. */
+    int index;
+};
+typedef struct id_sort_item IdSortItem;
+
+/**
+ * @brief Arguments of each thread of a parallel sort.
+ */
+struct id_sort_task {
+    /** First item of the range. */
+    IdSortItem *items;
+    /** Amount of items of the range, or of the first run when merging. */
+    int length;
+    /** Amount of items of the second run when merging. */
+    int secondLength;
+    /** Receives the merged runs. */
+    IdSortItem *output;
+};
+typedef struct id_sort_task IdSortTask;
+
+/**
+ * @brief Loads 8 bytes of the id as a big endian word, stopping on its
+ * terminator.
+ *
+ * Complexity: O(1).
+ *
+ * @param id The id, from the wanted depth.
+ * @return uint64_t The word.
+ */
+static uint64_t IdSort_loadPrefix(const char *id) {
+    uint64_t prefix = 0;
+    for (int i = 0; i < 8 && id[i] != '\0'; i += 1) {
+        prefix |= (uint64_t) (unsigned char) id[i] << (56 - 8 * i);
+    }
+    return prefix;
+}
+
+/**
+ * @brief Checks if the id ends inside the given cached word. The padding
+ * after the terminator is zero, so it ends if the last byte is zero.
+ */
+static int IdSort_endsOn(uint64_t prefix) {
+    return (prefix & 0xFF) == 0;
+}
+
+/**
+ * @brief Compares two items whose prefixes were loaded on the given depth,
+ * knowing their bytes before it are equal.
+ *
+ * n: The ids length.
+ * Complexity: O(n).
+ *
+ * @return int Negative, zero or positive, like strcmp.
+ */
+static int IdSort_compare(const IdSortItem *a, const IdSortItem *b,
+    int depth) {
+    if (a->prefix != b->prefix) {
+        return a->prefix < b->prefix ? -1 : 1;
+    }
+    if (IdSort_endsOn(a->prefix)) {
+        return 0;
+    }
+    return strcmp(a->id + depth + 8, b->id + depth + 8);
+}
+
+/**
+ * @brief Sorts a short range by insertion.
+ *
+ * n: The range length.
+ * Complexity: O(n^2).
+ */
+static void IdSort_insertion(IdSortItem *items, int length, int depth) {
+    for (int i = 1; i < length; i += 1) {
+        IdSortItem item = items[i];
+        int j = i - 1;
+        while (j >= 0 && IdSort_compare(&items[j], &item, depth) > 0) {
+            items[j + 1] = items[j];
+            j -= 1;
+        }
+        items[j + 1] = item;
+    }
+}
+
+/**
+ * @brief Swaps two items.
+ */
+static void IdSort_swap(IdSortItem *a, IdSortItem *b) {
+    IdSortItem temporary = *a;
+    *a = *b;
+    *b = temporary;
+}
+
+/**
+ * @brief Sorts the range with a multikey quicksort over 8 bytes words.
+ *
+ * The range is split in three by the cached words: the smaller and the
+ * greater parts are sorted on the same depth, and the equal part, if its ids
+ * do not end on the word, goes on to the next 8 bytes. The bytes before the
+ * depth are never compared again, so long common prefixes cost one pass each
+ * instead of one strcmp per comparison.
+ *
+ * n: The range length.
+ * L: The ids length.
+ * Complexity: O(n*log(n) + n*L/8) expected.
+ *
+ * @param items The range, with the prefixes loaded on the depth.
+ * @param length The range length.
+ * @param depth The amount of bytes known to be equal on the whole range.
+ */
+static void IdSort_multikey(IdSortItem *items, int length, int depth) {
+    while (length > ID_SORT_INSERTION_LENGTH) {
+        uint64_t first = items[0].prefix;
+        uint64_t middle = items[length / 2].prefix;
+        uint64_t last = items[length - 1].prefix;
+        uint64_t pivot = first < middle ?
+            (middle < last ? middle : (first < last ? last : first)) :
+            (first < last ? first : (middle < last ? last : middle));
+
+        // items[0, less) < pivot, items[less, i) == pivot, items(greater,
+        // length) > pivot.
+        int less = 0, i = 0, greater = length - 1;
+        while (i <= greater) {
+            if (items[i].prefix < pivot) {
+                IdSort_swap(&items[less++], &items[i++]);
+            } else if (items[i].prefix > pivot) {
+                IdSort_swap(&items[i], &items[greater--]);
+            } else {
+                i += 1;
+            }
+        }
+
+        IdSort_multikey(items, less, depth);
+        IdSort_multikey(items + greater + 1, length - greater - 1, depth);
+
+        if (IdSort_endsOn(pivot)) {
+            return;
+        }
+        items += less;
+        length = greater + 1 - less;
+        depth += 8;
+        for (i = 0; i < length; i += 1) {
+            items[i].prefix = IdSort_loadPrefix(items[i].id + depth);
+        }
+    }
+
+    IdSort_insertion(items, length, depth);
+}
+
+/**
+ * @brief Body of the threads sorting a range. The prefixes are loaded on the
+ * depth 0 before and after the sort, so the ranges can be merged.
+ *
+ * @param argument The IdSortTask of the thread.
+ * @return void* Always NULL.
+ */
+static void * IdSort_sortRange(void *argument) {
+    IdSortTask *task = (IdSortTask *) argument;
+    int i;
+
+    for (i = 0; i < task->length; i += 1) {
+        task->items[i].prefix = IdSort_loadPrefix(task->items[i].id);
+    }
+    IdSort_multikey(task->items, task->length, 0);
+    for (i = 0; i < task->length; i += 1) {
+        task->items[i].prefix = IdSort_loadPrefix(task->items[i].id);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Body of the threads merging two consecutive sorted runs. Ties keep
+ * the item of the first run first.
+ *
+ * @param argument The IdSortTask of the thread.
+ * @return void* Always NULL.
+ */
+static void * IdSort_mergeRuns(void *argument) {
+    IdSortTask *task = (IdSortTask *) argument;
+    IdSortItem *first = task->items;
+    IdSortItem *second = task->items + task->length;
+    int i = 0, j = 0, k = 0;
+
+    while (i < task->length && j < task->secondLength) {
+        if (IdSort_compare(&second[j], &first[i], 0) < 0) {
+            task->output[k++] = second[j++];
+        } else {
+            task->output[k++] = first[i++];
+        }
+    }
+    while (i < task->length) {
+        task->output[k++] = first[i++];
+    }
+    while (j < task->secondLength) {
+        task->output[k++] = second[j++];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Runs the tasks, one per thread. The calling thread runs the first,
+ * and also the ones whose thread could not be created.
+ *
+ * @param tasks The tasks.
+ * @param length The amount of tasks.
+ * @param body The thread body.
+ */
+static void IdSort_runTasks(IdSortTask *tasks, int length,
+    void * (*body)(void *)) {
+    pthread_t *handles = (pthread_t *) malloc(length * sizeof(pthread_t));
+    int created = 1, i;
+
+    while (handles && created < length && pthread_create(&handles[created],
+        NULL, body, &tasks[created]) == 0) {
+        created += 1;
+    }
+    body(&tasks[0]);
+    for (i = created; i < length; i += 1) {
+        body(&tasks[i]);
+    }
+    for (i = 1; i < created; i += 1) {
+        pthread_join(handles[i], NULL);
+    }
+
+    free(handles);
+}
+
+/**
+ * @brief Ids being sorted by IdSort_sortPositions, used by the comparison.
+ */
+static char **id_sort_positions;
+
+/**
+ * @brief Compares two positions of the ids by their ids.
+ */
+static int IdSort_comparePositions(const void *a, const void *b) {
+    return strcmp(id_sort_positions[*(const int *) a],
+        id_sort_positions[*(const int *) b]);
+}
+
+/**
+ * @brief Sorts the positions of the ids with the C library sort, without
+ * other memory than "order". Used when the multikey sort items can not be
+ * allocated.
+ *
+ * n: The amount of ids.
+ * Complexity: O(n*log(n)) comparisons.
+ *
+ * @param ids The ids. They are not modified.
+ * @param length The amount of ids.
+ * @param order Receives the position on "ids" of each sorted id.
+ */
+static void IdSort_sortPositions(char **ids, int length, int *order) {
+    for (int i = 0; i < length; i += 1) {
+        order[i] = i;
+    }
+    id_sort_positions = ids;
+    qsort(order, length, sizeof(int), IdSort_comparePositions);
+}
+
+/**
+ * @brief Sorts the ids, giving the same order as strcmp.
+ *
+ * The ids are split into one range per thread, and each range is sorted by a
+ * multikey quicksort with cached 8 bytes prefixes. The sorted ranges are then
+ * merged in pairs, also in parallel, until a single one is left. If their
+ * memory can not be allocated, the C library sort is used instead.
+ *
+ * n: The amount of ids.
+ * L: The ids length.
+ * Complexity: O(n*log(n) + n*L/8) expected, split among the threads.
+ *
+ * @param ids The ids. They are not modified.
+ * @param length The amount of ids.
+ * @param threads The amount of threads to be used.
+ * @param order Receives the position on "ids" of each sorted id, so
+ * ids[order[0]] is the smallest one.
+ */
+void IdSort_sort(char **ids, int length, int threads, int *order) {
+    int i;
+
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > length / ID_SORT_INSERTION_LENGTH) {
+        threads = length / ID_SORT_INSERTION_LENGTH > 0 ?
+            length / ID_SORT_INSERTION_LENGTH : 1;
+    }
+
+    IdSortItem *items = (IdSortItem *) malloc((length + 1) *
+        sizeof(IdSortItem));
+    IdSortItem *buffer = threads > 1 ?
+        (IdSortItem *) malloc((length + 1) * sizeof(IdSortItem)) : NULL;
+    // Runs limits: run "i" is items[runs[i], runs[i + 1]).
+    int *runs = (int *) malloc((threads + 1) * sizeof(int));
+    IdSortTask *tasks = (IdSortTask *) malloc(threads * sizeof(IdSortTask));
+    if (!items || (threads > 1 && !buffer) || !runs || !tasks) {
+        free(items);
+        free(buffer);
+        free(runs);
+        free(tasks);
+        IdSort_sortPositions(ids, length, order);
+        return;
+    }
+
+    for (i = 0; i < length; i += 1) {
+        items[i].id = ids[i];
+        items[i].index = i;
+    }
+    for (i = 0; i <= threads; i += 1) {
+        runs[i] = (long long) length * i / threads;
+    }
+    for (i = 0; i < threads; i += 1) {
+        tasks[i].items = items + runs[i];
+        tasks[i].length = runs[i + 1] - runs[i];
+    }
+    IdSort_runTasks(tasks, threads, IdSort_sortRange);
+
+    int runsNumber = threads;
+    while (runsNumber > 1) {
+        int pairs = runsNumber / 2;
+        for (i = 0; i < pairs; i += 1) {
+            tasks[i].items = items + runs[i * 2];
+            tasks[i].length = runs[i * 2 + 1] - runs[i * 2];
+            tasks[i].secondLength = runs[i * 2 + 2] - runs[i * 2 + 1];
+            tasks[i].output = buffer + runs[i * 2];
+        }
+        IdSort_runTasks(tasks, pairs, IdSort_mergeRuns);
+
+        // An odd run left alone is just copied.
+        if (runsNumber % 2 == 1) {
+            memcpy(buffer + runs[runsNumber - 1], items + runs[runsNumber - 1],
+                (runs[runsNumber] - runs[runsNumber - 1]) *
+                sizeof(IdSortItem));
+        }
+        for (i = 0; i <= pairs; i += 1) {
+            runs[i] = runs[i * 2 < runsNumber ? i * 2 : runsNumber];
+        }
+        runs[(runsNumber + 1) / 2] = length;
+        runsNumber = (runsNumber + 1) / 2;
+
+        IdSortItem *swap = items;
+        items = buffer;
+        buffer = swap;
+    }
+
+    for (i = 0; i < length; i += 1) {
+        order[i] = items[i].index;
+    }
+
+    free(items);
+    free(buffer);
+    free(runs);
+    free(tasks);
+}
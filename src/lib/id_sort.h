@@ -0,0 +1,6 @@
+#ifndef ID_SORT_H
+#define ID_SORT_H
+
+void IdSort_sort(char **ids, int length, int threads, int *order);
+
+#endif
@@ -0,0 +1,441 @@
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "input.h"
+
+/**
+ * @brief Size of each block read from a stream that can not be mapped.
+ */
+#define INPUT_BLOCK_SIZE (1 << 20)
+
+/**
+ * @brief Input structure.
+ *
+ * The whole input is kept on a single writable buffer, either mapped from the
+ * file or read from the standard input in large blocks. The tokens are
+ * terminated in place, so they are returned as pointers into the buffer and
+ * no string is copied. The buffer always has a writable byte after its
+ * content, so the last token can be terminated too.
+ */
+struct input {
+    /** The input content. */
+    char *buffer;
+    /** Length of the content. */
+    size_t length;
+    /** Position of the next byte to be scanned. */
+    size_t position;
+    /** Length of the mapping, or 0 if the buffer was allocated. */
+    size_t mappedLength;
+    /** If 0, the buffer belongs to another input and is not released. */
+    int ownsBuffer;
+    /** Descriptor of a streamed input, or -1 if the content is all loaded. */
+    int descriptor;
+    /** If 1, the stream reached its end. */
+    int ended;
+    /** Allocated length of the buffer of a streamed input. */
+    size_t capacity;
+    /** Previous buffer of a streamed input, kept so its tokens stay valid. */
+    char *retired;
+    /** Allocated length of the previous buffer. */
+    size_t retiredCapacity;
+};
+
+/**
+ * @brief Reads the whole stream into an allocated buffer, in large blocks.
+ *
+ * n: The stream length.
+ * Complexity: O(n).
+ *
+ * @param input The input to be filled.
+ * @param descriptor The stream file descriptor.
+ */
+static void Input_readStream(Input *input, int descriptor) {
+    size_t capacity = INPUT_BLOCK_SIZE;
+    input->buffer = (char *) malloc(capacity + 1);
+    input->length = 0;
+
+    while (1) {
+        if (capacity - input->length < INPUT_BLOCK_SIZE) {
+            capacity *= 2;
+            input->buffer = (char *) realloc(input->buffer, capacity + 1);
+        }
+
+        ssize_t bytes = read(descriptor, input->buffer + input->length,
+            capacity - input->length);
+        if (bytes <= 0) {
+            break;
+        }
+        input->length += bytes;
+    }
+
+    input->buffer[input->length] = '\0';
+}
+
+/**
+ * @brief Opens the input.
+ *
+ * A regular file is mapped privately, so writing the token terminators does
+ * not change it. If the file length is a multiple of the page size, there is
+ * no spare byte after the content on the mapping, so the file is read instead.
+ * The standard input is always read.
+ *
+ * n: The input length.
+ * Complexity: O(1) for mapped files, O(n) otherwise.
+ *
+ * @param path The file path, or NULL for the standard input.
+ * @return Input* A pointer to the opened input. NULL if the file could not be
+ * opened.
+ */
+Input * Input_open(const char *path) {
+    int descriptor = path ? open(path, O_RDONLY) : STDIN_FILENO;
+    if (descriptor < 0) {
+        return NULL;
+    }
+
+    Input *input = (Input *) malloc(sizeof(Input));
+    input->position = 0;
+    input->mappedLength = 0;
+    input->ownsBuffer = 1;
+    input->descriptor = -1;
+    input->retired = NULL;
+
+    struct stat status;
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (
+        path &&
+        fstat(descriptor, &status) == 0 &&
+        S_ISREG(status.st_mode) &&
+        status.st_size > 0 &&
+        status.st_size % pageSize != 0
+    ) {
+        void *mapping = mmap(NULL, status.st_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE, descriptor, 0);
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, status.st_size, MADV_SEQUENTIAL);
+            input->buffer = (char *) mapping;
+            input->length = status.st_size;
+            input->mappedLength = status.st_size;
+        }
+    }
+
+    if (input->mappedLength == 0) {
+        Input_readStream(input, descriptor);
+    }
+
+    if (path) {
+        close(descriptor);
+    }
+
+    return input;
+}
+
+/**
+ * @brief Refills the window of a streamed input, so at least INPUT_BLOCK_SIZE
+ * bytes are available after the position, unless the stream ends before.
+ *
+ * The bytes not scanned yet are copied to the start of a new buffer, and the
+ * current one is retired instead of released, so the tokens returned from it
+ * stay valid until the next refill.
+ *
+ * Complexity: O(INPUT_BLOCK_SIZE), plus the read.
+ *
+ * @param input The streamed input.
+ */
+static void Input_refill(Input *input) {
+    size_t remaining = input->length - input->position;
+    size_t capacity = input->retiredCapacity;
+    char *buffer = input->retired;
+
+    if (capacity < remaining + INPUT_BLOCK_SIZE) {
+        capacity = input->capacity > remaining + INPUT_BLOCK_SIZE ?
+            input->capacity : 2 * (remaining + INPUT_BLOCK_SIZE);
+        buffer = (char *) realloc(buffer, capacity + 1);
+    }
+    memcpy(buffer, input->buffer + input->position, remaining);
+
+    input->retired = input->buffer;
+    input->retiredCapacity = input->capacity;
+    input->buffer = buffer;
+    input->capacity = capacity;
+    input->length = remaining;
+    input->position = 0;
+
+    while (!input->ended && input->length < capacity) {
+        ssize_t bytes = read(input->descriptor, buffer + input->length,
+            capacity - input->length);
+        if (bytes <= 0) {
+            input->ended = 1;
+            break;
+        }
+        input->length += bytes;
+    }
+    buffer[input->length] = '\0';
+}
+
+/**
+ * @brief Opens the input as a stream, read on a window of about
+ * 2*INPUT_BLOCK_SIZE bytes instead of being loaded or mapped whole, so inputs
+ * larger than the memory can be scanned.
+ *
+ * The tokens are still terminated in place, but the window slides as the
+ * input is read: a token stays valid while less than INPUT_BLOCK_SIZE / 2
+ * bytes are read after it, which is always enough for the few tokens of a
+ * line.
+ * Input_takeLines can not be used on it.
+ *
+ * Complexity: O(1).
+ *
+ * @param path The file path, or NULL for the standard input.
+ * @return Input* A pointer to the opened input. NULL if the file could not be
+ * opened.
+ */
+Input * Input_openStream(const char *path) {
+    int descriptor = path ? open(path, O_RDONLY) : STDIN_FILENO;
+    if (descriptor < 0) {
+        return NULL;
+    }
+
+    Input *input = (Input *) malloc(sizeof(Input));
+    input->buffer = (char *) malloc(1);
+    input->buffer[0] = '\0';
+    input->length = 0;
+    input->capacity = 0;
+    input->position = 0;
+    input->mappedLength = 0;
+    input->ownsBuffer = 1;
+    input->descriptor = descriptor;
+    input->ended = 0;
+    input->retired = NULL;
+    input->retiredCapacity = 0;
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(descriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    Input_refill(input);
+    return input;
+}
+
+/**
+ * @brief Closes the input. The tokens returned by it are no longer valid.
+ *
+ * Complexity: O(1).
+ *
+ * @param input The input to be closed.
+ */
+void Input_close(Input *input) {
+    if (!input->ownsBuffer) {
+        free(input);
+        return;
+    }
+
+    if (input->mappedLength > 0) {
+        munmap(input->buffer, input->mappedLength);
+    } else {
+        free(input->buffer);
+    }
+    if (input->descriptor >= 0 && input->descriptor != STDIN_FILENO) {
+        close(input->descriptor);
+    }
+    free(input->retired);
+    free(input);
+}
+
+/**
+ * @brief Checks if the given byte separates tokens. Every control character
+ * and the space are separators.
+ *
+ * Complexity: O(1).
+ *
+ * @param byte The byte.
+ * @return int 1 if it is a separator, 0 otherwise.
+ */
+static int Input_isSeparator(char byte) {
+    return (unsigned char) byte <= ' ';
+}
+
+/**
+ * @brief Opens an input over a region of another input buffer, as returned by
+ * Input_takeLines. Closing it does not release the buffer.
+ *
+ * Complexity: O(1).
+ *
+ * @param buffer The region start.
+ * @param length The region length. The region must end with a separator, so
+ * its last token is terminated inside it.
+ * @return Input* A pointer to the opened input.
+ */
+Input * Input_openRegion(char *buffer, size_t length) {
+    Input *input = (Input *) malloc(sizeof(Input));
+    input->buffer = buffer;
+    input->length = length;
+    input->position = 0;
+    input->mappedLength = 0;
+    input->ownsBuffer = 0;
+    input->descriptor = -1;
+    input->retired = NULL;
+    return input;
+}
+
+/**
+ * @brief Takes the next lines of the input as a raw region, skipping them.
+ *
+ * The lines are found with memchr, which is much cheaper than tokenizing, so
+ * the region can be split and tokenized by several threads with
+ * Input_openRegion.
+ *
+ * n: The region length.
+ * Complexity: O(n).
+ *
+ * @param input The input.
+ * @param lines The amount of lines. The separators before the first one are
+ * skipped.
+ * @param length Receives the region length, including the last line break.
+ * @return char* The region start.
+ */
+char * Input_takeLines(Input *input, int lines, size_t *length) {
+    char *start = input->buffer + input->position;
+    char *end = input->buffer + input->length;
+
+    // Skips what is left of the current line, like a "\r\n" line break.
+    while (start < end && Input_isSeparator(*start)) {
+        start++;
+    }
+    char *current = start;
+
+    while (lines > 0 && current < end) {
+        char *lineBreak = memchr(current, '\n', end - current);
+        current = lineBreak ? lineBreak + 1 : end;
+        lines -= 1;
+    }
+
+    input->position = current - input->buffer;
+    *length = current - start;
+    return start;
+}
+
+/**
+ * @brief Checks if any of the 8 bytes of the word is a separator, comparing
+ * all of them at once.
+ *
+ * Complexity: O(1).
+ *
+ * @param word 8 bytes of the input.
+ * @return int Non zero if there is a separator on the word.
+ */
+static uint64_t Input_hasSeparator(uint64_t word) {
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    return (word - ones * (' ' + 1)) & ~word & highs;
+}
+
+/**
+ * @brief Returns the next token of the input, terminating it in place.
+ *
+ * The token end is searched 8 bytes at a time while there are enough bytes
+ * left, and byte by byte around the separator.
+ *
+ * n: The length of the token plus the separators before it.
+ * Complexity: O(n).
+ *
+ * @param input The input.
+ * @param length Receives the token length. Can be NULL.
+ * @return char* Pointer to the token on the input buffer. NULL if there is no
+ * token left.
+ */
+char * Input_nextToken(Input *input, int *length) {
+    if (input->descriptor >= 0 && !input->ended &&
+        input->length - input->position < INPUT_BLOCK_SIZE / 2) {
+        Input_refill(input);
+    }
+
+    char *buffer = input->buffer;
+    size_t position = input->position;
+
+    while (position < input->length && Input_isSeparator(buffer[position])) {
+        position++;
+    }
+    if (position >= input->length) {
+        input->position = position;
+        return NULL;
+    }
+
+    size_t start = position;
+    while (position + sizeof(uint64_t) <= input->length) {
+        uint64_t word;
+        memcpy(&word, buffer + position, sizeof(uint64_t));
+        if (Input_hasSeparator(word)) {
+            break;
+        }
+        position += sizeof(uint64_t);
+    }
+    while (position < input->length && !Input_isSeparator(buffer[position])) {
+        position++;
+    }
+
+    // A token longer than the window is scanned again on a larger one.
+    if (position == input->length && input->descriptor >= 0 &&
+        !input->ended) {
+        input->position = start;
+        Input_refill(input);
+        return Input_nextToken(input, length);
+    }
+
+    buffer[position] = '\0';
+    input->position = position < input->length ? position + 1 : position;
+
+    if (length) {
+        *length = position - start;
+    }
+    return buffer + start;
+}
+
+/**
+ * @brief Reads the next token as a decimal integer, without going through the
+ * locale aware stdio functions.
+ *
+ * n: The length of the token plus the separators before it.
+ * Complexity: O(n).
+ *
+ * @param input The input.
+ * @param value Receives the integer.
+ * @return int 1 if an integer was read, 0 if there is no token left, it is
+ * not an integer or it does not fit on an int.
+ */
+int Input_nextInt(Input *input, int *value) {
+    char *token = Input_nextToken(input, NULL);
+    if (token == NULL) {
+        return 0;
+    }
+
+    int negative = *token == '-';
+    if (*token == '-' || *token == '+') {
+        token++;
+    }
+    if (*token == '\0') {
+        return 0;
+    }
+
+    // The magnitude is accumulated as unsigned, so INT_MIN is accepted and
+    // anything beyond the int range is rejected before it wraps.
+    unsigned int limit = negative ? (unsigned int) INT_MAX + 1 : INT_MAX;
+    unsigned int result = 0;
+    for (; *token != '\0'; token++) {
+        if (*token < '0' || *token > '9') {
+            return 0;
+        }
+        unsigned int digit = *token - '0';
+        if (result > (limit - digit) / 10) {
+            return 0;
+        }
+        result = result * 10 + digit;
+    }
+
+    *value = negative ? (int) (0U - result) : (int) result;
+    return 1;
+}
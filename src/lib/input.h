@@ -0,0 +1,22 @@
+#include <stddef.h>
+
+#ifndef INPUT_H
+#define INPUT_H
+
+typedef struct input Input;
+
+Input * Input_open(const char *path);
+
+Input * Input_openStream(const char *path);
+
+Input * Input_openRegion(char *buffer, size_t length);
+
+void Input_close(Input *input);
+
+char * Input_takeLines(Input *input, int lines, size_t *length);
+
+char * Input_nextToken(Input *input, int *length);
+
+int Input_nextInt(Input *input, int *value);
+
+#endif
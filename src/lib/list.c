@@ -1,85 +1,39 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "list.h"
+#include "arena.h"
+#include "metrics.h"
 
 /**
- * @brief Cell structure
- *
- * Structure for a cell. This is used to implement the linked list.
- */
-struct cell {
-    /** Next cell on the list */
-    struct cell *next;
-    /** Previous cell on the list */
-    struct cell *previous;
-    /** Stored data */
-    void *data;
-};
-typedef struct cell Cell;
-
-/**
- * @brief Create a new Cell
- *
- * This function will create a new cell. The next and previous item will be set
- * to NULL and the stored data will be set to the specified data.
- *
- * Complexity: O(1)
- *
- * @param[in] data  Pointer to the data
- *
- * @return Returns a pointer to a new empty Cell.
- */
-static Cell * Cell_create(void *data) {
-    Cell *cell = malloc(sizeof(Cell));
-
-    cell->next = NULL;
-    cell->previous = NULL;
-    cell->data = data;
-
-    return cell;
-}
-
-/**
- * @brief Destroy a Cell
- *
- * This function destroys the given cell. Pass the appropriated
- * destructor for destroying the stored data.
- *
- * Complexity: O(1).
- *
- * @param cell The cell
- * @param[in] destructor  The destructor for the cell data
+ * @brief Capacity of the items array on the first insertion.
  */
-static void Cell_destroy(Cell *cell) {
-    free(cell);
-}
+#define LIST_INITIAL_CAPACITY 4
 
 /**
  * @brief List structure
  *
- * This will be the structure of the list.
+ * This will be the structure of the list. The items are stored on a growable
+ * contiguous array, so any position is reached in O(1) and appending costs no
+ * allocation per item.
  */
 struct list {
-    /** Pointer to the first item on the list. */
-    Cell *first;
-    /** Pointer to the last item on the list. */
-    Cell *last;
-    /**
-     * LRA is a short for "Last Recently Used". It is the last cell that was
-     * acessed on the list, and it"s positions.
-     */
-    Cell *lru_cell;
-    int lru_cell_position;
+    /** Array with the stored data, on the list order. */
+    void **items;
+    /** Allocated length of the items array. */
+    int capacity;
     /** Used to store the current size of the list. */
     int size;
+    /** Arena where the list and its items are allocated. NULL for malloc. */
+    Arena *arena;
 };
 
 
 /**
  * @brief Create a List
  *
- * This function create a empty list. The first and last item and size is set
- * to NULL and 0, respectively.
+ * This function create a empty list. The items array is only allocated on the
+ * first insertion.
  *
  * Complexity: O(1)
  *
@@ -88,26 +42,49 @@ struct list {
 List * List_create() {
     List *list = malloc(sizeof(List));
 
-    list->first = NULL;
-    list->last = NULL;
-    list->lru_cell = NULL;
-    list->lru_cell_position = 0;
+    list->items = NULL;
+    list->capacity = 0;
+    list->size = 0;
+    list->arena = NULL;
+
+    return list;
+}
+
+/**
+ * @brief Create a List on the given arena
+ *
+ * Same as List_create, but the list and its items array are allocated on the
+ * arena. Such list must not be destroyed with List_destroy: it is released
+ * together with the arena.
+ *
+ * Complexity: O(1)
+ *
+ * @param arena The arena
+ * @return Returns the pointer to the created list
+ */
+List * List_createInArena(Arena *arena) {
+    List *list = Arena_alloc(arena, sizeof(List));
+
+    list->items = NULL;
+    list->capacity = 0;
     list->size = 0;
+    list->arena = arena;
 
     return list;
 }
 
 /**
  * @brief Destroy the given list
- * 
- * Destroy the list. It assumes that all the elements of the list were destroyed
- * by who was using it, using the List_removeItem until the list is empty.
+ *
+ * Destroy the list and its items array. It assumes that the stored data was
+ * destroyed by who was using it.
  *
  * Complexity: O(1).
  *
  * @param list The list
  */
 void List_destroy(List *list) {
+    free(list->items);
     free(list);
 }
 
@@ -123,14 +100,49 @@ int List_getSize(List *list) {
     return list->size;
 }
 
+/**
+ * @brief Grows the items array to hold at least the given amount of items,
+ * doubling its capacity.
+ *
+ * An arena list can not release its old array, so it is left on the arena.
+ *
+ * n: The list size.
+ * Complexity: O(n), O(1) amortized over the insertions.
+ *
+ * @param list The list.
+ * @param size The wanted capacity.
+ */
+static void List_reserve(List *list, int size) {
+    if (size <= list->capacity) {
+        return;
+    }
+
+    int capacity = list->capacity == 0 ? LIST_INITIAL_CAPACITY : list->capacity;
+    while (capacity < size) {
+        capacity *= 2;
+    }
+
+    METRICS_COUNT(METRICS_LIST_GROWTHS);
+    if (list->arena) {
+        void **items = Arena_alloc(list->arena, capacity * sizeof(void *));
+        if (list->size > 0) {
+            memcpy(items, list->items, list->size * sizeof(void *));
+        }
+        list->items = items;
+    } else {
+        list->items = realloc(list->items, capacity * sizeof(void *));
+    }
+    list->capacity = capacity;
+}
+
 /**
  * @brief Calculates the position.
- * 
+ *
  * It normalizes the given position according to the given size, allowing the
  * position to be negative and greater than the size.
- * 
+ *
  * * Complexity: O(1).
- * 
+ *
  * @param position The desired position.
  * @param size The size of the list.
  * @return int The positive position.
@@ -159,220 +171,141 @@ static int List_calculatePosition(int position, int size) {
     return position;
 }
 
-/**
- * @brief Gets the cell of a list on the given position
- * 
- * n: the cell position
- * Complexity: O(n) on the worst case. If the caller is iterating
- * sequentially on the list, the complexity turns into O(1), because the least
- * recently used position will be used to start the search.
- * 
- * @param list The list
- * @param position The cell position
- * @return Cell* A pointer to the cell. NULL if not found.
- */
-static Cell * List_getCell(List *list, int position) {
-    position = List_calculatePosition(position, list->size);
-
-    Cell *current_cell = NULL;
-    int current_cell_position = 0;
-
-    int lru_cell_distance = abs(position - list->lru_cell_position);
-    int first_cell_distance = position;
-    int last_cell_distance = abs((list->size - 1) - position);
-
-    /*
-     * If the position is more closer to the least recently used cell than the
-     * first and the last cell.
-     */
-    if (
-        list->lru_cell != NULL &&
-        lru_cell_distance < first_cell_distance &&
-        lru_cell_distance < last_cell_distance
-    ) {
-        current_cell_position = list->lru_cell_position;
-        current_cell = list->lru_cell;
-    }
-    /* If the position is more closer to the last cell. */
-    else if (last_cell_distance < first_cell_distance) {
-        current_cell_position = list->size - 1;
-        current_cell = list->last;
-    }
-    /* If the position is more closer to the first cell. */
-    else {
-        current_cell_position = 0;
-        current_cell = list->first;
-    }
-
-    /* If the we have to search backwards. */
-    if (current_cell_position > position) {
-        while (current_cell_position > position) {
-            current_cell = current_cell->previous;
-            current_cell_position--;
-        }
-    }
-    /* If the we have to search forwards. */
-    else {
-        while (current_cell_position < position) {
-            current_cell = current_cell->next;
-            current_cell_position++;
-        }
-    }
-
-    list->lru_cell = current_cell;
-    list->lru_cell_position = position;
-
-    return current_cell;
-}
-
 /**
  * @brief Insert an item with the given data
  *
- * This function will insert a cell in a determined position of the given list,
- * containing the given data.
+ * This function will insert an item in a determined position of the given
+ * list, containing the given data. The items after it are moved one position.
  *
- * n: the item position
- * Complexity: O(n)
+ * n: the amount of items after the position
+ * Complexity: O(n), O(1) amortized at the end of the list.
  *
  * @param list List to insert the given item
  * @param data The data of the item
  * @param[in] position Position that the item will be inserted. It can be
  * positive or negative. Negative numbers will be interpreted as positions at
- * the end of the list.
+ * the end of the list: -1 appends the item.
  *
  * @return The position (positive) that the item was inserted
  */
 int List_insertItem(List *list, void *data, int position) {
-    Cell *cell = Cell_create(data);
-    Cell *current = List_getCell(list, position);
-
-    /*
-     * Check if the list is empty.
-     */
-    if (current == NULL) {
-        list->first = cell;
-        list->last = cell;
-        list->size += 1;
+    if (list->size == 0) {
+        List_reserve(list, 1);
+        list->items[0] = data;
+        list->size = 1;
         return 0;
     }
 
-    /* The cell have to be inserted on the first position */
-    if (list->first == current && position == 0) {
-        list->first = cell;
-        cell->next = current;
-        current->previous = cell;
-    }
-    /* The cell have to be inserted on the last position */
-    else if (list->last == current && position == -1) {
-        list->last = cell;
-        cell->previous = current;
-        current->next = cell;
-    }
-    /* The cell have to be inserted on the middle of 2 others cells */
-    else {
-        /* If the specified position is negative, the cell have to be inserted
-         * after the current cell. This way, the cell index keeps being
-         * negative.
-         */
-        if (position < 0) {
-            current->next->previous = cell;
-            cell->next = current->next;
-            cell->previous = current;
-            current->next = cell;
-        } else {
-            current->previous->next = cell;
-            cell->previous = current->previous;
-            cell->next = current;
-            current->previous = cell;
-        }
+    // A negative position inserts after the item on that position.
+    int index = position < 0 ?
+        List_calculatePosition(position, list->size) + 1 :
+        List_calculatePosition(position, list->size);
+    if (index < 0) {
+        index = 0;
     }
 
-    list->size++;
+    List_reserve(list, list->size + 1);
+    if (index < list->size) {
+        memmove(list->items + index + 1, list->items + index,
+            (list->size - index) * sizeof(void *));
+    }
+    list->items[index] = data;
+    list->size += 1;
 
     return position;
 }
 
+/**
+ * @brief Appends several items to the end of the list at once, growing the
+ * items array a single time.
+ *
+ * n: The amount of items.
+ * Complexity: O(n) amortized.
+ *
+ * @param list The list.
+ * @param items Array with the data of the items.
+ * @param length The amount of items.
+ */
+void List_appendItems(List *list, void **items, int length) {
+    if (length <= 0) {
+        return;
+    }
+
+    List_reserve(list, list->size + length);
+    memcpy(list->items + list->size, items, length * sizeof(void *));
+    list->size += length;
+}
+
 /**
  * @brief Removes a item from the given list.
  *
- * This function will remove a cell in a determined position of the
- * given list, returning the cell's data and detroying it.
+ * This function will remove the item in a determined position of the
+ * given list, returning its data. The items after it are moved back one
+ * position.
  *
- * n: the item position.
- * Complexity: O(n).
+ * n: the amount of items after the position.
+ * Complexity: O(n), O(1) at the end of the list.
  *
  * @param list The list.
  * @param[in] position The position of the item to be removed. It can be
  * positive or negative. Negative numbers will be interpreted as positions at
  * the end of the list.
  *
- * @return The data of the removed item.
+ * @return The data of the removed item. NULL if the list is empty.
  */
 void * List_removeItem(List *list, int position) {
-    void *data;
-
-    /*
-     * Check if the list is empty.
-     */
-    if (list->first == NULL && list->last == NULL) {
+    if (list->size == 0) {
         return NULL;
     }
-    /*
-     * Check if the list has just one element
-     */
-    else if (list->first == list->last) {
-        data = list->first->data;
-        Cell_destroy(list->first);
-        list->first = NULL;
-        list->last = NULL;
-        list->size = 0;
-        return data;
-    }
 
-    Cell *current = List_getCell(list, position);
-
-    /* The cell have to be removed from the first position */
-    if (list->first == current && position == 0) {
-        list->first = current->next;
-        list->first->previous = NULL;
-    }
-    /* The cell have to be removed from the last position */
-    else if (list->last == current && position == -1) {
-        list->last = current->previous;
-        list->last->next = NULL;
+    int index = List_calculatePosition(position, list->size);
+    if (index < 0) {
+        index = 0;
     }
-    /* The cell have to be removed from the middle of 2 others cells */
-    else {
-        current->previous->next = current->next;
-        current->next->previous = current->previous;
-    }
-
-    if (list->lru_cell == current) {
-        list->lru_cell = NULL;
-        list->lru_cell_position = 0;
+    if (index >= list->size) {
+        index = list->size - 1;
     }
 
+    void *data = list->items[index];
     list->size -= 1;
-    data = current->data;
-    Cell_destroy(current);
+    if (index < list->size) {
+        memmove(list->items + index, list->items + index + 1,
+            (list->size - index) * sizeof(void *));
+    }
 
     return data;
 }
 
 /**
  * @brief Get the item on the given position
- * 
- * n: the item position
- * Complexity: O(n).
- * 
+ *
+ * Complexity: O(1).
+ *
  * @param list The list
- * @param position The position of the item
+ * @param position The position of the item. Negative numbers will be
+ * interpreted as positions at the end of the list.
  * @return void* The data on the item. NULL if not found.
  */
 void * List_getItem(List *list, int position) {
-    Cell *cell = List_getCell(list, position);
-    if (cell == NULL) {
+    if (position < 0) {
+        position += list->size;
+    }
+    if (position < 0 || position >= list->size) {
         return NULL;
     }
-    return cell->data;
+    return list->items[position];
+}
+
+/**
+ * @brief Getter for the items array, to iterate over the list without a call
+ * per item. The array is only valid until the next insertion or removal.
+ *
+ * Complexity: O(1).
+ *
+ * @param list The list
+ * @return void** Pointer to the first of List_getSize items. NULL if the list
+ * never had items.
+ */
+void ** List_getItems(List *list) {
+    return list->items;
 }
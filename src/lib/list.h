@@ -1,3 +1,5 @@
+#include "arena.h"
+
 #ifndef LIST_H
 #define LIST_H
 
@@ -5,14 +7,20 @@ typedef struct list List;
 
 List * List_create();
 
+List * List_createInArena(Arena *arena);
+
 void List_destroy(List *list);
 
 int List_getSize(List *list);
 
 int List_insertItem(List *list, void *data, int position);
 
+void List_appendItems(List *list, void **items, int length);
+
 void * List_removeItem(List *list, int position);
 
 void * List_getItem(List *list, int position);
 
+void ** List_getItems(List *list);
+
 #endif
\ No newline at end of file
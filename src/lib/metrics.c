@@ -0,0 +1,171 @@
+#include "metrics.h"
+
+#ifdef TP0_METRICS
+
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+/**
+ * @brief Maximum amount of distinct phases.
+ */
+#define METRICS_MAX_PHASES 16
+
+static const char *METRICS_COUNTER_NAMES[METRICS_COUNTERS_NUMBER] = {
+    "search_comparisons", "list_growths", "index_lookups", "index_probes",
+    "spread_max_depth"
+};
+
+/**
+ * @brief Time spent on a phase. A phase started more than once accumulates
+ * the time of all of them.
+ */
+struct metrics_phase {
+    /** The phase name. */
+    const char *name;
+    /** Elapsed wall time, in seconds. */
+    double wall;
+    /** Elapsed CPU time of the whole process, in seconds. */
+    double cpu;
+};
+typedef struct metrics_phase MetricsPhase;
+
+/** The phases, in the order they first started. */
+static MetricsPhase metrics_phases[METRICS_MAX_PHASES];
+/** The amount of phases. */
+static int metrics_phases_number = 0;
+/** The running phase. -1 if none. */
+static int metrics_current_phase = -1;
+/** Wall and CPU times when the running phase started. */
+static double metrics_phase_wall, metrics_phase_cpu;
+/** Value of each counter. The depth counters hold their maximum. */
+static long long metrics_counters[METRICS_COUNTERS_NUMBER];
+/** Current value of the depth counters. */
+static long long metrics_depths[METRICS_COUNTERS_NUMBER];
+
+/**
+ * @brief Reads the given clock.
+ *
+ * @param clock The clock id.
+ * @return double The time, in seconds.
+ */
+static double Metrics_now(clockid_t clock) {
+    struct timespec time;
+    clock_gettime(clock, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Adds the time since the running phase started to it.
+ *
+ * Complexity: O(1).
+ */
+static void Metrics_endPhase() {
+    if (metrics_current_phase < 0) {
+        return;
+    }
+    MetricsPhase *phase = &metrics_phases[metrics_current_phase];
+    phase->wall += Metrics_now(CLOCK_MONOTONIC) - metrics_phase_wall;
+    phase->cpu += Metrics_now(CLOCK_PROCESS_CPUTIME_ID) - metrics_phase_cpu;
+    metrics_current_phase = -1;
+}
+
+/**
+ * @brief Ends the running phase, if any, and starts the given one.
+ *
+ * n: The amount of phases.
+ * Complexity: O(n).
+ *
+ * @param name The phase name. It must live until the report.
+ */
+void Metrics_startPhase(const char *name) {
+    int i;
+
+    Metrics_endPhase();
+    for (i = 0; i < metrics_phases_number; i += 1) {
+        if (strcmp(metrics_phases[i].name, name) == 0) {
+            break;
+        }
+    }
+    if (i == METRICS_MAX_PHASES) {
+        return;
+    }
+    if (i == metrics_phases_number) {
+        metrics_phases[i].name = name;
+        metrics_phases[i].wall = metrics_phases[i].cpu = 0;
+        metrics_phases_number += 1;
+    }
+
+    metrics_current_phase = i;
+    metrics_phase_wall = Metrics_now(CLOCK_MONOTONIC);
+    metrics_phase_cpu = Metrics_now(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+/**
+ * @brief Adds the value to the counter. It may be called by several threads.
+ *
+ * Complexity: O(1).
+ *
+ * @param counter The counter, one of the METRICS_* constants.
+ * @param value The value to be added.
+ */
+void Metrics_add(int counter, long long value) {
+    __atomic_fetch_add(&metrics_counters[counter], value, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Enters one level of a depth counter, keeping its maximum. Only for
+ * single threaded code, such as the recursive spreads.
+ *
+ * Complexity: O(1).
+ *
+ * @param counter The counter, one of the METRICS_* constants.
+ */
+void Metrics_enter(int counter) {
+    metrics_depths[counter] += 1;
+    if (metrics_depths[counter] > metrics_counters[counter]) {
+        metrics_counters[counter] = metrics_depths[counter];
+    }
+}
+
+/**
+ * @brief Leaves one level of a depth counter.
+ *
+ * Complexity: O(1).
+ *
+ * @param counter The counter, one of the METRICS_* constants.
+ */
+void Metrics_leave(int counter) {
+    metrics_depths[counter] -= 1;
+}
+
+/**
+ * @brief Ends the running phase and writes the phases times, the counters
+ * and the peak resident memory as a single JSON line.
+ *
+ * Complexity: O(1).
+ *
+ * @param output Where the JSON is written.
+ */
+void Metrics_report(FILE *output) {
+    struct rusage usage;
+    int i;
+
+    Metrics_endPhase();
+    getrusage(RUSAGE_SELF, &usage);
+
+    fprintf(output, "{\"phases\":[");
+    for (i = 0; i < metrics_phases_number; i += 1) {
+        fprintf(output, "%s{\"name\":\"%s\",\"wall_ms\":%.3f,\"cpu_ms\":%.3f}",
+            i > 0 ? "," : "", metrics_phases[i].name,
+            metrics_phases[i].wall * 1000, metrics_phases[i].cpu * 1000);
+    }
+    fprintf(output, "],\"counters\":{");
+    for (i = 0; i < METRICS_COUNTERS_NUMBER; i += 1) {
+        fprintf(output, "%s\"%s\":%lld", i > 0 ? "," : "",
+            METRICS_COUNTER_NAMES[i], metrics_counters[i]);
+    }
+    fprintf(output, "},\"peak_rss_kb\":%ld}\n", usage.ru_maxrss);
+}
+
+#endif
@@ -0,0 +1,52 @@
+#include <stdio.h>
+
+#ifndef METRICS_H
+#define METRICS_H
+
+/** Comparisons of ids made by the binary searches of the sorted people. */
+#define METRICS_SEARCH_COMPARISONS 0
+/** Allocations of list items arrays, made when a list grows. */
+#define METRICS_LIST_GROWTHS 1
+/** Lookups on the person hash index. */
+#define METRICS_INDEX_LOOKUPS 2
+/** Slots visited by the lookups on the person hash index. */
+#define METRICS_INDEX_PROBES 3
+/** Deepest recursion reached by the recursive spreads. */
+#define METRICS_SPREAD_DEPTH 4
+/** Amount of counters. */
+#define METRICS_COUNTERS_NUMBER 5
+
+/**
+ * The instrumentation only exists on builds with TP0_METRICS defined
+ * ("make METRICS=1"). Otherwise the macros expand to nothing, so the hot
+ * paths are the same as without them.
+ */
+#ifdef TP0_METRICS
+
+#define METRICS_PHASE(name) Metrics_startPhase(name)
+#define METRICS_COUNT(counter) Metrics_add(counter, 1)
+#define METRICS_ENTER(counter) Metrics_enter(counter)
+#define METRICS_LEAVE(counter) Metrics_leave(counter)
+#define METRICS_REPORT() Metrics_report(stderr)
+
+void Metrics_startPhase(const char *name);
+
+void Metrics_add(int counter, long long value);
+
+void Metrics_enter(int counter);
+
+void Metrics_leave(int counter);
+
+void Metrics_report(FILE *output);
+
+#else
+
+#define METRICS_PHASE(name) ((void) 0)
+#define METRICS_COUNT(counter) ((void) 0)
+#define METRICS_ENTER(counter) ((void) 0)
+#define METRICS_LEAVE(counter) ((void) 0)
+#define METRICS_REPORT() ((void) 0)
+
+#endif
+
+#endif
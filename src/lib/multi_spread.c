@@ -0,0 +1,170 @@
+#include <stdlib.h>
+#include <string.h>
+#include "multi_spread.h"
+#include "csr_graph.h"
+
+/**
+ * @brief State of the traversals, reused by all the groups of seeds.
+ */
+struct multi_spread {
+    /** The graph being searched. */
+    CsrGraph *graph;
+    /** Flag per vertex telling if the spread goes through it. */
+    const unsigned char *eligible;
+    /** Bit "i" of a vertex mask is set if the group's seed "i" reaches it. */
+    unsigned long long *masks;
+    /** Flag per vertex telling if it is waiting on the queue. */
+    unsigned char *queued;
+    /** Circular queue of the vertices whose mask has bits not propagated. */
+    int *queue;
+    /** The vertices with a non zero mask, so they can be counted and reset. */
+    int *touched;
+    /** Amount of touched vertices. */
+    int touchedNumber;
+    /** The graph's vertices number, also the queue length. */
+    int verticesNumber;
+};
+typedef struct multi_spread MultiSpread;
+
+/**
+ * @brief Propagates the masks of the queued vertices until none of them
+ * changes.
+ *
+ * A vertex is queued again whenever it receives a bit it did not have, so
+ * it is expanded at most once per seed of the group, and usually much less:
+ * the seeds in the same component travel together on the same word.
+ *
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * Complexity: O(V+E) per distinct arrival of bits, O(64*(V+E)) worst case.
+ *
+ * @param spread The state, with the seeds queued.
+ * @param first Position of the first queued vertex.
+ * @param size Amount of queued vertices.
+ */
+static void MultiSpread_propagate(MultiSpread *spread, int first, int size) {
+    unsigned long long *masks = spread->masks;
+    unsigned char *queued = spread->queued;
+    int *queue = spread->queue;
+    int length = spread->verticesNumber;
+
+    while (size > 0) {
+        int vertex = queue[first];
+        first = first + 1 == length ? 0 : first + 1;
+        size -= 1;
+        queued[vertex] = 0;
+
+        unsigned long long mask = masks[vertex];
+        int degree = CsrGraph_getDegree(spread->graph, vertex);
+        int *neighbors = CsrGraph_getNeighbors(spread->graph, vertex);
+        for (int i = 0; i < degree; i += 1) {
+            int related = neighbors[i];
+            if (!spread->eligible[related] ||
+                (masks[related] | mask) == masks[related]) {
+                continue;
+            }
+
+            if (masks[related] == 0) {
+                spread->touched[spread->touchedNumber++] = related;
+            }
+            masks[related] |= mask;
+            if (!queued[related]) {
+                queued[related] = 1;
+                queue[(first + size) % length] = related;
+                size += 1;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Spreads the music from a group of at most MULTI_SPREAD_LANES seeds
+ * at once and adds, to each seed count, the vertices its bit reached.
+ *
+ * @param spread The state, with all the masks zeroed.
+ * @param seeds The group's seeds. Negative ones are ignored.
+ * @param length The group's length.
+ * @param counts Receives the count of each seed of the group.
+ */
+static void MultiSpread_runGroup(MultiSpread *spread, const int *seeds,
+    int length, int *counts) {
+    int size = 0, i;
+
+    spread->touchedNumber = 0;
+    for (i = 0; i < length; i += 1) {
+        int seed = seeds[i];
+        counts[i] = 0;
+        if (seed < 0 || !spread->eligible[seed]) {
+            continue;
+        }
+
+        if (spread->masks[seed] == 0) {
+            spread->touched[spread->touchedNumber++] = seed;
+        }
+        spread->masks[seed] |= 1ULL << i;
+        if (!spread->queued[seed]) {
+            spread->queued[seed] = 1;
+            spread->queue[size++] = seed;
+        }
+    }
+
+    MultiSpread_propagate(spread, 0, size);
+
+    for (i = 0; i < spread->touchedNumber; i += 1) {
+        int vertex = spread->touched[i];
+        unsigned long long mask = spread->masks[vertex];
+        while (mask) {
+            counts[__builtin_ctzll(mask)] += 1;
+            mask &= mask - 1;
+        }
+        spread->masks[vertex] = 0;
+    }
+}
+
+/**
+ * @brief Spreads the music from every seed, giving the same counts as one
+ * spread per seed, but with the seeds packed on 64 bits words.
+ *
+ * Each vertex holds a mask with one bit per seed of the current group, and
+ * the masks are propagated through the eligible vertices until they stop
+ * changing. Seeds on the same component share every traversal step, so a
+ * group of seeds costs about one traversal of the components they touch
+ * instead of one per seed. No one is marked as listened.
+ *
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * S: The amount of seeds.
+ * Complexity: O(S/64*(V+E)) for seeds on few components, O(S*(V+E)) worst
+ * case.
+ *
+ * @param graph The CSR graph.
+ * @param eligible Flag per vertex telling if the spread goes through it.
+ * @param seeds The vertex of each first listener. Negative ones get 0.
+ * @param length The amount of seeds.
+ * @param counts Receives how many people liked the music from each seed.
+ */
+void MultiSpread_run(CsrGraph *graph, const unsigned char *eligible,
+    const int *seeds, int length, int *counts) {
+    MultiSpread spread;
+    int verticesNumber = CsrGraph_getVerticesNumber(graph);
+
+    spread.graph = graph;
+    spread.eligible = eligible;
+    spread.verticesNumber = verticesNumber;
+    spread.masks = (unsigned long long *) calloc(verticesNumber + 1,
+        sizeof(unsigned long long));
+    spread.queued = (unsigned char *) calloc(verticesNumber + 1, 1);
+    spread.queue = (int *) malloc((verticesNumber + 1) * sizeof(int));
+    spread.touched = (int *) malloc((verticesNumber + 1) * sizeof(int));
+
+    for (int i = 0; i < length; i += MULTI_SPREAD_LANES) {
+        int group = length - i < MULTI_SPREAD_LANES ?
+            length - i : MULTI_SPREAD_LANES;
+        MultiSpread_runGroup(&spread, seeds + i, group, counts + i);
+    }
+
+    free(spread.masks);
+    free(spread.queued);
+    free(spread.queue);
+    free(spread.touched);
+}
@@ -0,0 +1,12 @@
+#include "csr_graph.h"
+
+#ifndef MULTI_SPREAD_H
+#define MULTI_SPREAD_H
+
+/** Amount of seeds propagated together by a single traversal. */
+#define MULTI_SPREAD_LANES 64
+
+void MultiSpread_run(CsrGraph *graph, const unsigned char *eligible,
+    const int *seeds, int length, int *counts);
+
+#endif
@@ -0,0 +1,443 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parallel_bfs.h"
+#include "csr_graph.h"
+
+/**
+ * @brief Heuristic parameters from Beamer et al. (2012). The search switches
+ * to bottom-up when the edges leaving the frontier are more than 1/ALPHA of
+ * the edges still unexplored, and back to top-down when the frontier has less
+ * than 1/BETA of the vertices.
+ */
+#define PARALLEL_BFS_ALPHA 14
+#define PARALLEL_BFS_BETA 24
+
+/**
+ * @brief ParallelBfs structure.
+ *
+ * Everything that depends only on the graph is computed once, on the
+ * creation, so each search costs only the levels it processes: the flags,
+ * the amount of edges leaving eligible vertices and the level bitmaps are
+ * reused by all the searches. The worker threads are also started once and
+ * wait on the barrier between the searches. It also holds the state shared
+ * by the threads of the running search.
+ */
+struct parallel_bfs {
+    /** The graph being searched. */
+    CsrGraph *graph;
+    /** Flag per vertex telling if the search can expand through it. */
+    unsigned char *eligible;
+    /** Amount of edges leaving eligible vertices. */
+    long long eligibleEdges;
+    /** The graph's vertices number. */
+    int verticesNumber;
+    /** Length of the bitmaps, in words. */
+    int words;
+    /** Amount of threads working on the search. */
+    int threads;
+    /** Bitmap of the vertices reached by the search. */
+    unsigned long long *visited;
+    /** Bitmap used as the visited one when the caller gives none. */
+    unsigned long long *ownVisited;
+    /** Called for each reached vertex after the search, or NULL. */
+    ParallelBfsVisit visit;
+    /** Context given to the visit function. */
+    void *context;
+    /** Bitmap of the vertices on the current level. */
+    unsigned long long *frontier;
+    /** Bitmap of the vertices on the next level. */
+    unsigned long long *next;
+    /** Barrier used to synchronize the threads between levels. */
+    pthread_barrier_t barrier;
+    /** The range of each thread, the first one run by the caller. */
+    struct parallel_bfs_worker *workers;
+    /** Handle of each worker thread, the first one unused. */
+    pthread_t *handles;
+    /** If 1, the worker threads exit instead of searching. */
+    int stopped;
+    /** If 1, the current level is processed bottom-up. */
+    int bottomUp;
+    /** If 1, there is no level left. */
+    int done;
+    /** Amount of vertices on the frontier. */
+    long long frontierSize;
+    /** Amount of edges leaving the frontier. */
+    long long frontierEdges;
+    /** Amount of edges leaving eligible vertices not reached yet. */
+    long long unexploredEdges;
+    /** Amount of vertices reached on the level being processed. */
+    long long nextSize;
+    /** Amount of edges leaving the vertices reached on the level. */
+    long long nextEdges;
+    /** Amount of vertices reached so far. */
+    int counter;
+};
+
+/**
+ * @brief Arguments of each worker thread.
+ */
+struct parallel_bfs_worker {
+    /** The shared state. */
+    ParallelBfs *bfs;
+    /** The first bitmap word owned by the thread. */
+    int firstWord;
+    /** The word after the last one owned by the thread. */
+    int lastWord;
+};
+typedef struct parallel_bfs_worker ParallelBfsWorker;
+
+/**
+ * @brief Checks if the given vertex is set on the bitmap.
+ *
+ * Complexity: O(1).
+ *
+ * @param bitmap The bitmap.
+ * @param vertex The vertex index.
+ * @return int 1 if it is set, 0 otherwise.
+ */
+static int ParallelBfs_test(unsigned long long *bitmap, int vertex) {
+    unsigned long long word = __atomic_load_n(&bitmap[vertex / 64],
+        __ATOMIC_RELAXED);
+    return (word >> (vertex % 64)) & 1;
+}
+
+/**
+ * @brief Expands the frontier words owned by the thread, visiting the
+ * unvisited eligible neighbors of each frontier vertex. Different threads may
+ * reach the same vertex, so the marks are set atomically.
+ *
+ * n: The amount of vertices owned by the thread.
+ * E: The amount of edges leaving them.
+ * Complexity: O(n+E).
+ *
+ * @param worker The worker.
+ * @param reached Incremented for each vertex reached.
+ * @param edges Incremented with the degree of each vertex reached.
+ */
+static void ParallelBfs_stepTopDown(ParallelBfsWorker *worker,
+    long long *reached, long long *edges) {
+    ParallelBfs *bfs = worker->bfs;
+
+    for (int w = worker->firstWord; w < worker->lastWord; w += 1) {
+        unsigned long long word = bfs->frontier[w];
+        while (word) {
+            int vertex = w * 64 + __builtin_ctzll(word);
+            word &= word - 1;
+
+            int degree = CsrGraph_getDegree(bfs->graph, vertex);
+            int *neighbors = CsrGraph_getNeighbors(bfs->graph, vertex);
+            for (int i = 0; i < degree; i += 1) {
+                int related = neighbors[i];
+                unsigned long long bit = 1ULL << (related % 64);
+                if (!bfs->eligible[related] ||
+                    ParallelBfs_test(bfs->visited, related)) {
+                    continue;
+                }
+
+                unsigned long long old = __atomic_fetch_or(
+                    &bfs->visited[related / 64], bit, __ATOMIC_RELAXED);
+                if (!(old & bit)) {
+                    __atomic_fetch_or(&bfs->next[related / 64], bit,
+                        __ATOMIC_RELAXED);
+                    *reached += 1;
+                    *edges += CsrGraph_getDegree(bfs->graph, related);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Looks for a frontier neighbor of each unvisited eligible vertex owned
+ * by the thread. Only the owner writes on its words, so no atomic operation is
+ * needed, and the neighbors scan stops on the first frontier vertex found.
+ *
+ * n: The amount of vertices owned by the thread.
+ * E: The amount of edges leaving them.
+ * Complexity: O(n+E).
+ *
+ * @param worker The worker.
+ * @param reached Incremented for each vertex reached.
+ * @param edges Incremented with the degree of each vertex reached.
+ */
+static void ParallelBfs_stepBottomUp(ParallelBfsWorker *worker,
+    long long *reached, long long *edges) {
+    ParallelBfs *bfs = worker->bfs;
+
+    for (int w = worker->firstWord; w < worker->lastWord; w += 1) {
+        for (int bit = 0; bit < 64; bit += 1) {
+            int vertex = w * 64 + bit;
+            if (vertex >= bfs->verticesNumber) {
+                break;
+            }
+            if (!bfs->eligible[vertex] || ((bfs->visited[w] >> bit) & 1)) {
+                continue;
+            }
+
+            int degree = CsrGraph_getDegree(bfs->graph, vertex);
+            int *neighbors = CsrGraph_getNeighbors(bfs->graph, vertex);
+            for (int i = 0; i < degree; i += 1) {
+                if (ParallelBfs_test(bfs->frontier, neighbors[i])) {
+                    bfs->visited[w] |= 1ULL << bit;
+                    bfs->next[w] |= 1ULL << bit;
+                    *reached += 1;
+                    *edges += degree;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Chooses the direction of the next level and swaps the bitmaps. Runs
+ * on a single thread, while the others wait on the barrier.
+ *
+ * Complexity: O(1).
+ *
+ * @param bfs The shared state.
+ */
+static void ParallelBfs_advance(ParallelBfs *bfs) {
+    unsigned long long *frontier = bfs->frontier;
+    bfs->frontier = bfs->next;
+    bfs->next = frontier;
+
+    bfs->counter += bfs->nextSize;
+    bfs->unexploredEdges -= bfs->nextEdges;
+    bfs->frontierSize = bfs->nextSize;
+    bfs->frontierEdges = bfs->nextEdges;
+    bfs->done = bfs->nextSize == 0;
+    bfs->nextSize = 0;
+    bfs->nextEdges = 0;
+
+    if (!bfs->bottomUp &&
+        bfs->frontierEdges > bfs->unexploredEdges / PARALLEL_BFS_ALPHA) {
+        bfs->bottomUp = 1;
+    } else if (bfs->bottomUp &&
+        bfs->frontierSize < bfs->verticesNumber / PARALLEL_BFS_BETA) {
+        bfs->bottomUp = 0;
+    }
+}
+
+/**
+ * @brief Calls the visit function for each reached vertex owned by the
+ * thread. The internal visited bitmap is cleaned for the next search.
+ *
+ * n: The amount of vertices owned by the thread.
+ * Complexity: O(n/64) plus the visits.
+ *
+ * @param worker The worker.
+ */
+static void ParallelBfs_finish(ParallelBfsWorker *worker) {
+    ParallelBfs *bfs = worker->bfs;
+
+    for (int w = worker->firstWord; w < worker->lastWord; w += 1) {
+        unsigned long long word = bfs->visited[w];
+        if (bfs->visit) {
+            while (word) {
+                bfs->visit(bfs->context, w * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+        if (bfs->visited == bfs->ownVisited) {
+            bfs->visited[w] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Runs the thread's part of a search. Processes its share of each
+ * level until the frontier is empty, and then visits its share of the
+ * reached vertices.
+ *
+ * @param worker The worker.
+ * @return int 1 after a search, 0 if the search was destroyed instead.
+ */
+static int ParallelBfs_work(ParallelBfsWorker *worker) {
+    ParallelBfs *bfs = worker->bfs;
+    int isLeader = worker->firstWord == 0;
+
+    while (1) {
+        pthread_barrier_wait(&bfs->barrier);
+        if (bfs->stopped) {
+            return 0;
+        }
+        if (bfs->done) {
+            // Both level bitmaps are clean here, ready for the next search.
+            ParallelBfs_finish(worker);
+            // The caller returns only when every visit is done.
+            pthread_barrier_wait(&bfs->barrier);
+            return 1;
+        }
+
+        long long reached = 0, edges = 0;
+        if (bfs->bottomUp) {
+            ParallelBfs_stepBottomUp(worker, &reached, &edges);
+        } else {
+            ParallelBfs_stepTopDown(worker, &reached, &edges);
+        }
+        __atomic_fetch_add(&bfs->nextSize, reached, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&bfs->nextEdges, edges, __ATOMIC_RELAXED);
+
+        pthread_barrier_wait(&bfs->barrier);
+        if (isLeader) {
+            ParallelBfs_advance(bfs);
+        }
+        pthread_barrier_wait(&bfs->barrier);
+
+        // The old frontier is the next level bitmap now, so it is cleaned.
+        memset(bfs->next + worker->firstWord, 0,
+            (worker->lastWord - worker->firstWord) *
+            sizeof(unsigned long long));
+    }
+}
+
+/**
+ * @brief Body of each worker thread. Runs its part of every search until the
+ * search is destroyed.
+ *
+ * @param argument The ParallelBfsWorker of the thread.
+ * @return void* Always NULL.
+ */
+static void * ParallelBfs_serve(void *argument) {
+    while (ParallelBfs_work((ParallelBfsWorker *) argument)) {
+    }
+    return NULL;
+}
+
+/**
+ * @brief Creates a search over the given graph. The amount of edges leaving
+ * eligible vertices is counted once here, instead of on every search, and
+ * the worker threads are started, waiting for the searches.
+ *
+ * V: The graph's vertices number.
+ * Complexity: O(V).
+ *
+ * @param graph The built CSR graph. It must not change while the search
+ * exists.
+ * @param eligible Flag per vertex, 1 if the search can expand through it.
+ * Allocated with malloc, the search takes its ownership.
+ * @param threads The amount of threads to be used by each search.
+ * @return ParallelBfs* A pointer to the created search.
+ */
+ParallelBfs * ParallelBfs_create(CsrGraph *graph, unsigned char *eligible,
+    int threads) {
+    ParallelBfs *bfs = (ParallelBfs *) malloc(sizeof(ParallelBfs));
+    bfs->graph = graph;
+    bfs->eligible = eligible;
+    bfs->verticesNumber = CsrGraph_getVerticesNumber(graph);
+    bfs->words = PARALLEL_BFS_WORDS(bfs->verticesNumber);
+    bfs->frontier = (unsigned long long *) calloc(bfs->words + 1,
+        sizeof(unsigned long long));
+    bfs->next = (unsigned long long *) calloc(bfs->words + 1,
+        sizeof(unsigned long long));
+    bfs->ownVisited = (unsigned long long *) calloc(bfs->words + 1,
+        sizeof(unsigned long long));
+
+    bfs->eligibleEdges = 0;
+    for (int i = 0; i < bfs->verticesNumber; i += 1) {
+        if (eligible[i]) {
+            bfs->eligibleEdges += CsrGraph_getDegree(graph, i);
+        }
+    }
+
+    if (threads > bfs->words) {
+        threads = bfs->words;
+    }
+    bfs->threads = threads = threads < 1 ? 1 : threads;
+    bfs->stopped = 0;
+    pthread_barrier_init(&bfs->barrier, NULL, threads);
+
+    bfs->workers = (ParallelBfsWorker *) malloc(threads *
+        sizeof(ParallelBfsWorker));
+    bfs->handles = (pthread_t *) malloc(threads * sizeof(pthread_t));
+    for (int i = 0; i < threads; i += 1) {
+        bfs->workers[i].bfs = bfs;
+        bfs->workers[i].firstWord = (long long) bfs->words * i / threads;
+        bfs->workers[i].lastWord = (long long) bfs->words * (i + 1) / threads;
+    }
+    // The calling thread of each search works as the first worker.
+    for (int i = 1; i < threads; i += 1) {
+        pthread_create(&bfs->handles[i], NULL, ParallelBfs_serve,
+            &bfs->workers[i]);
+    }
+    return bfs;
+}
+
+/**
+ * @brief Destroys the given search and its eligible flags, stopping the
+ * worker threads.
+ *
+ * T: The amount of threads.
+ * Complexity: O(T).
+ *
+ * @param bfs The search to be destroyed.
+ */
+void ParallelBfs_destroy(ParallelBfs *bfs) {
+    bfs->stopped = 1;
+    pthread_barrier_wait(&bfs->barrier);
+    for (int i = 1; i < bfs->threads; i += 1) {
+        pthread_join(bfs->handles[i], NULL);
+    }
+    pthread_barrier_destroy(&bfs->barrier);
+
+    free(bfs->workers);
+    free(bfs->handles);
+    free(bfs->eligible);
+    free(bfs->frontier);
+    free(bfs->next);
+    free(bfs->ownVisited);
+    free(bfs);
+}
+
+/**
+ * @brief Level-synchronous, direction-optimizing breadth first search.
+ *
+ * It searches from the start vertex expanding only through the eligible
+ * vertices, and counts how many eligible vertices were reached. Each level is
+ * split among the threads by ranges of bitmap words. The levels are processed
+ * top-down (frontier vertices look for unvisited neighbors) while the frontier
+ * is small, and bottom-up (unvisited vertices look for frontier neighbors)
+ * when it is large. After the last level, each thread calls the visit
+ * function for the reached vertices of its range. The worker threads started
+ * on the creation are woken by the barrier, so a search starts no thread.
+ *
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * Complexity: O(V+E) work per level on the worst case, O(V+E) in total on
+ * top-down only searches, split among the threads.
+ *
+ * @param bfs The search.
+ * @param start The start vertex index.
+ * @param visited Zeroed bitmap with PARALLEL_BFS_WORDS(V) words, which
+ * receives the reached vertices, or NULL to use an internal one, cleaned
+ * after the visits.
+ * @param visit Called for each reached vertex, or NULL.
+ * @param context Context given to the visit function.
+ * @return int The amount of vertices reached. 0 if the start is not eligible.
+ */
+int ParallelBfs_search(ParallelBfs *bfs, int start,
+    unsigned long long *visited, ParallelBfsVisit visit, void *context) {
+    if (!bfs->eligible[start]) {
+        return 0;
+    }
+
+    bfs->visited = visited ? visited : bfs->ownVisited;
+    bfs->visit = visit;
+    bfs->context = context;
+    bfs->bottomUp = 0;
+    bfs->done = 0;
+    bfs->nextSize = 0;
+    bfs->nextEdges = 0;
+    bfs->counter = 1;
+    bfs->frontierSize = 1;
+    bfs->frontierEdges = CsrGraph_getDegree(bfs->graph, start);
+    bfs->unexploredEdges = bfs->eligibleEdges - bfs->frontierEdges;
+
+    bfs->visited[start / 64] |= 1ULL << (start % 64);
+    bfs->frontier[start / 64] |= 1ULL << (start % 64);
+    ParallelBfs_work(&bfs->workers[0]);
+
+    return bfs->counter;
+}
@@ -0,0 +1,25 @@
+#include "csr_graph.h"
+
+#ifndef PARALLEL_BFS_H
+#define PARALLEL_BFS_H
+
+/** Amount of 64 bits words needed by a bitmap with the given length. */
+#define PARALLEL_BFS_WORDS(length) (((length) + 63) / 64)
+
+typedef struct parallel_bfs ParallelBfs;
+
+/**
+ * @brief Called by the worker threads for each vertex reached by a search,
+ * after the search ends. Different threads call it at the same time.
+ */
+typedef void (*ParallelBfsVisit)(void *context, int vertex);
+
+ParallelBfs * ParallelBfs_create(CsrGraph *graph, unsigned char *eligible,
+    int threads);
+
+void ParallelBfs_destroy(ParallelBfs *bfs);
+
+int ParallelBfs_search(ParallelBfs *bfs, int start,
+    unsigned long long *visited, ParallelBfsVisit visit, void *context);
+
+#endif
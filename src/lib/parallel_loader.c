@@ -0,0 +1,244 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parallel_loader.h"
+#include "csr_graph.h"
+#include "input.h"
+#include "person.h"
+
+/**
+ * @brief State shared by all the threads of a load.
+ */
+struct parallel_loader {
+    /** The graph holding the people, used to resolve the ids, or NULL. */
+    Graph *graph;
+    /** The table holding the people, used instead of the graph, or NULL. */
+    PersonTable *table;
+    /** The hash index of the people, or NULL to use the binary search. */
+    PersonIndex *index;
+    /** The amount of vertices. */
+    int verticesNumber;
+    /** Degree of each vertex, and then the position of its neighbors. */
+    int *offsets;
+    /** Next free position of each vertex neighborhood. */
+    int *cursors;
+    /** The neighbors of all vertices. */
+    int *neighbors;
+    /** Barrier used to separate the phases. */
+    pthread_barrier_t barrier;
+};
+typedef struct parallel_loader ParallelLoader;
+
+/**
+ * @brief Arguments and edges buffer of each worker thread.
+ */
+struct parallel_loader_worker {
+    /** The shared state. */
+    ParallelLoader *loader;
+    /** If 1, the thread also runs the sequential steps. */
+    int isLeader;
+    /** Start of the lines parsed by the thread. */
+    char *region;
+    /** Length of the region. */
+    size_t regionLength;
+    /** The resolved edges, as pairs of vertex indices. */
+    int *edges;
+    /** Amount of edges on the buffer. */
+    int edgesNumber;
+    /** Allocated amount of edges on the buffer. */
+    int edgesCapacity;
+};
+typedef struct parallel_loader_worker ParallelLoaderWorker;
+
+/**
+ * @brief Parses the edges on the worker region, resolving the ids to vertex
+ * indices and appending them to the worker buffer. Edges with unknown ids are
+ * discarded, like on the sequential load.
+ *
+ * n: The region length.
+ * E: The amount of edges on the region.
+ * Complexity: O(n) with the hash index, O(n + E*log(V)) otherwise.
+ *
+ * @param worker The worker.
+ */
+static void ParallelLoader_parse(ParallelLoaderWorker *worker) {
+    ParallelLoader *loader = worker->loader;
+    Input *input = Input_openRegion(worker->region, worker->regionLength);
+
+    while (1) {
+        char *id1 = Input_nextToken(input, NULL);
+        char *id2 = Input_nextToken(input, NULL);
+        if (id1 == NULL || id2 == NULL) {
+            break;
+        }
+
+        int index1, index2;
+        if (loader->index) {
+            index1 = PersonIndex_search(loader->index, id1);
+            index2 = PersonIndex_search(loader->index, id2);
+        } else if (loader->table) {
+            index1 = PersonTable_searchId(loader->table, id1);
+            index2 = PersonTable_searchId(loader->table, id2);
+        } else {
+            index1 = Graph_searchPersonIndexById(loader->graph, id1);
+            index2 = Graph_searchPersonIndexById(loader->graph, id2);
+        }
+        if (index1 < 0 || index2 < 0) {
+            continue;
+        }
+
+        if (worker->edgesNumber == worker->edgesCapacity) {
+            worker->edgesCapacity = worker->edgesCapacity * 2 + 1024;
+            worker->edges = (int *) realloc(worker->edges,
+                worker->edgesCapacity * 2 * sizeof(int));
+        }
+        worker->edges[worker->edgesNumber * 2] = index1;
+        worker->edges[worker->edgesNumber * 2 + 1] = index2;
+        worker->edgesNumber += 1;
+    }
+
+    Input_close(input);
+}
+
+/**
+ * @brief Body of each thread: parses its region, counts the degrees of its
+ * edges and, after the leader computes the offsets, scatters its edges on the
+ * CSR neighbors array. The counting and the scattering use atomic operations
+ * on the shared arrays.
+ *
+ * @param argument The ParallelLoaderWorker of the thread.
+ * @return void* Always NULL.
+ */
+static void * ParallelLoader_work(void *argument) {
+    ParallelLoaderWorker *worker = (ParallelLoaderWorker *) argument;
+    ParallelLoader *loader = worker->loader;
+    int i;
+
+    ParallelLoader_parse(worker);
+
+    for (i = 0; i < worker->edgesNumber * 2; i += 1) {
+        __atomic_fetch_add(&loader->offsets[worker->edges[i] + 1], 1,
+            __ATOMIC_RELAXED);
+    }
+
+    pthread_barrier_wait(&loader->barrier);
+    if (worker->isLeader) {
+        for (i = 0; i < loader->verticesNumber; i += 1) {
+            loader->offsets[i + 1] += loader->offsets[i];
+        }
+        memcpy(loader->cursors, loader->offsets,
+            loader->verticesNumber * sizeof(int));
+        loader->neighbors = (int *) malloc(
+            (loader->offsets[loader->verticesNumber] + 1) * sizeof(int));
+    }
+    pthread_barrier_wait(&loader->barrier);
+
+    for (i = 0; i < worker->edgesNumber; i += 1) {
+        int vertex1 = worker->edges[i * 2];
+        int vertex2 = worker->edges[i * 2 + 1];
+        int position1 = __atomic_fetch_add(&loader->cursors[vertex1], 1,
+            __ATOMIC_RELAXED);
+        int position2 = __atomic_fetch_add(&loader->cursors[vertex2], 1,
+            __ATOMIC_RELAXED);
+        loader->neighbors[position1] = vertex2;
+        loader->neighbors[position2] = vertex1;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Loads the edges section of the input into a CSR graph using several
+ * threads.
+ *
+ * The section lines are taken at once and split into one region per thread,
+ * on line breaks, so each line must hold exactly one edge. Each thread parses
+ * its region and resolves the ids into its own buffer, then all of them count
+ * the degrees and scatter the edges on the CSR arrays. The order of the
+ * neighbors of a vertex depends on the threads scheduling.
+ *
+ * n: The edges section length.
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * Complexity: O(n+V+E) with the hash index, split among the threads, except
+ * for the O(V) offsets prefix sum.
+ *
+ * @param input The input, positioned at the start of the edges section.
+ * @param edgesNumber The amount of edges (lines) of the section.
+ * @param graph The graph holding the people, or NULL if the table is given.
+ * @param table The table holding the people, or NULL if the graph is given.
+ * @param index The hash index of the people, or NULL if the graph or the table
+ * is sorted.
+ * @param threads The amount of threads to be used.
+ * @return CsrGraph* The built CSR graph, with the undirected edges.
+ */
+CsrGraph * ParallelLoader_loadEdges(Input *input, int edgesNumber,
+    Graph *graph, PersonTable *table, PersonIndex *index, int threads) {
+    ParallelLoader loader;
+    size_t length;
+    char *region = Input_takeLines(input, edgesNumber, &length);
+    int i;
+
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    loader.graph = graph;
+    loader.table = table;
+    loader.index = index;
+    loader.verticesNumber = table ? PersonTable_getLength(table) :
+        Graph_getVerticesNumber(graph);
+    loader.offsets = (int *) calloc(loader.verticesNumber + 1, sizeof(int));
+    loader.cursors = (int *) malloc((loader.verticesNumber + 1) * sizeof(int));
+    loader.neighbors = NULL;
+    pthread_barrier_init(&loader.barrier, NULL, threads);
+
+    ParallelLoaderWorker *workers = (ParallelLoaderWorker *) malloc(threads *
+        sizeof(ParallelLoaderWorker));
+    pthread_t *handles = (pthread_t *) malloc(threads * sizeof(pthread_t));
+
+    // Splits the section on the first line break after each even split point.
+    char *start = region;
+    char *end = region + length;
+    for (i = 0; i < threads; i += 1) {
+        char *split = region + length / threads * (i + 1);
+        if (i == threads - 1 || split >= end) {
+            split = end;
+        } else {
+            char *lineBreak = memchr(split, '\n', end - split);
+            split = lineBreak ? lineBreak + 1 : end;
+        }
+        if (split < start) {
+            split = start;
+        }
+
+        workers[i].loader = &loader;
+        workers[i].isLeader = i == 0;
+        workers[i].region = start;
+        workers[i].regionLength = split - start;
+        workers[i].edges = NULL;
+        workers[i].edgesNumber = 0;
+        workers[i].edgesCapacity = 0;
+        start = split;
+    }
+
+    // The calling thread works as the first worker.
+    for (i = 1; i < threads; i += 1) {
+        pthread_create(&handles[i], NULL, ParallelLoader_work, &workers[i]);
+    }
+    ParallelLoader_work(&workers[0]);
+    for (i = 1; i < threads; i += 1) {
+        pthread_join(handles[i], NULL);
+    }
+
+    for (i = 0; i < threads; i += 1) {
+        free(workers[i].edges);
+    }
+    pthread_barrier_destroy(&loader.barrier);
+    free(workers);
+    free(handles);
+    free(loader.cursors);
+
+    return CsrGraph_createFromArrays(loader.verticesNumber, loader.offsets,
+        loader.neighbors);
+}
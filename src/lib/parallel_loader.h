@@ -0,0 +1,12 @@
+#include "csr_graph.h"
+#include "input.h"
+#include "person.h"
+#include "person_table.h"
+
+#ifndef PARALLEL_LOADER_H
+#define PARALLEL_LOADER_H
+
+CsrGraph * ParallelLoader_loadEdges(Input *input, int edgesNumber,
+    Graph *graph, PersonTable *table, PersonIndex *index, int threads);
+
+#endif
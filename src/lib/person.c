@@ -1,9 +1,22 @@
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "person.h"
 #include "graph.h"
+#include "csr_graph.h"
+#include "compact_graph.h"
+#include "frontier.h"
+#include "parallel_bfs.h"
+#include "spread_index.h"
 #include "list.h"
+#include "hash.h"
+#include "arena.h"
+#include "person_table.h"
+#include "id_sort.h"
+#include "metrics.h"
+#include "multi_spread.h"
+#include "age_index.h"
 
 /**
  * @brief Person structure.
@@ -13,13 +26,34 @@ struct person {
     char *id;
     /** The person age */
     int age;
-    /** Flag indicating if the person listened to the music. */
+    /**
+     * Spread epoch on which the person listened to the music. The person has
+     * listened on the current spread if it is equal to spread_epoch.
+     */
     int listened;
 };
 
+/**
+ * @brief Current spread epoch. Incrementing it resets the listened mark of
+ * every person at once.
+ */
+static int spread_epoch = 1;
+
+/**
+ * @brief Resets the listened marks of all people, so a new spread can run on
+ * the same graph.
+ * 
+ * Complexity: O(1).
+ */
+void Person_resetSpread() {
+    spread_epoch += 1;
+}
+
 /**
  * @brief Creates a new person with the given id and age
  * 
+ * The id is not copied, so it must stay valid while the person exists.
+ * 
  * Complexity: O(1).
  * 
  * @param id The person id.
@@ -36,56 +70,131 @@ Person * Person_create(char *id, int age) {
     return person;
 }
 
+/**
+ * @brief Creates a new person with the given id and age on the given arena
+ * 
+ * The person is released together with the arena, so Person_destroy must not
+ * be called. The id is not copied.
+ * 
+ * Complexity: O(1).
+ * 
+ * @param arena The arena.
+ * @param id The person id.
+ * @param age The person age
+ * @return Person* A pointer to the new person.
+ */
+Person * Person_createInArena(Arena *arena, char *id, int age) {
+    Person *person = (Person *) Arena_alloc(arena, sizeof(Person));
+
+    person->id = id;
+    person->age = age;
+    person->listened = 0;
+
+    return person;
+}
+
+/**
+ * @brief Getter for the person id.
+ * 
+ * Complexity: O(1).
+ * 
+ * @param person The person.
+ * @return char* The person id.
+ */
+char * Person_getId(Person *person) {
+    return person->id;
+}
+
+/**
+ * @brief Getter for the person age.
+ * 
+ * Complexity: O(1).
+ * 
+ * @param person The person.
+ * @return int The person age.
+ */
+int Person_getAge(Person *person) {
+    return person->age;
+}
+
+/**
+ * @brief Setter for the person age.
+ *
+ * Complexity: O(1).
+ *
+ * @param person The person.
+ * @param age The new age.
+ */
+void Person_setAge(Person *person, int age) {
+    person->age = age;
+}
+
 /**
  * @brief Destroys the given person. It simply free the allocated memory to 
- * store the data.
+ * store the data. The id is owned by who created the person.
  * 
  * Complexity: O(1).
  * 
  * @param person The person to be destroyed.
  */
 void Person_destroy(void *person) {
-    free(((Person *) person)->id);
     free(person);
 }
 
 /**
- * @brief Recursivelly searches the vertex with the desired person using the
+ * @brief Searches the index of the vertex with the desired person using the
  * binary search approach.
  * 
  * n: The length of the vertices array
  * Complexity: O(log(n))
  * 
- * @param vertices The vertices array.
+ * @param vertices The vertices array, sorted by person id.
  * @param length The vertices array length.
  * @param id The person id.
- * @return Vertex* The vertex found
+ * @return int The index of the vertex found. -1 if not found.
  */
-static Vertex * Graph_binarySearchPersonVertexById(
+static int Graph_binarySearchPersonIndexById(
     Vertex **vertices,
     int length,
     char *id
 ) {
-    if (length == 0) {
-        return NULL;
-    }
+    int left = 0, right = length - 1;
 
-    int middle = length / 2;
-    Person *middle_person = (Person *) Vertex_getData(vertices[middle]);
-    char *middle_person_id = middle_person->id;
+    while (left <= right) {
+        int middle = left + (right - left) / 2;
+        Person *middle_person = (Person *) Vertex_getData(vertices[middle]);
+        int comparison = strcmp(id, middle_person->id);
+        METRICS_COUNT(METRICS_SEARCH_COMPARISONS);
 
-    if (strcmp(id, middle_person_id) == 0) {
-        return vertices[middle];
-    }
+        if (comparison == 0) {
+            return middle;
+        }
 
-    if (strcmp(id, middle_person_id) > 0) {
-        // Right side of the array
-        return Graph_binarySearchPersonVertexById(vertices + middle,
-            length - middle, id);
+        if (comparison > 0) {
+            // Right side of the array
+            left = middle + 1;
+        } else {
+            // Left side of the array
+            right = middle - 1;
+        }
     }
 
-    // Left side of the array
-    return Graph_binarySearchPersonVertexById(vertices, length - middle, id);
+    return -1;
+}
+
+/**
+ * @brief Search the person's vertex index given the person id.
+ * 
+ * n: The length of the vertices array
+ * Complexity: O(log(n))
+ * 
+ * @param graph The graph, sorted with Graph_sortVerticesByPersonId.
+ * @param id The person's id.
+ * @return int The person's vertex index on the graph. -1 if not found.
+ */
+int Graph_searchPersonIndexById(Graph *graph, char *id) {
+    return Graph_binarySearchPersonIndexById(Graph_getVertices(graph),
+        Graph_getVerticesNumber(graph), id);
 }
 
 /**
@@ -94,13 +203,210 @@ static Vertex * Graph_binarySearchPersonVertexById(
  * n: The length of the vertices array
  * Complexity: O(log(n))
  * 
- * @param graph The graph.
+ * @param graph The graph, sorted with Graph_sortVerticesByPersonId.
  * @param id The person's id.
- * @return Vertex* The person's vertex.
+ * @return Vertex* The person's vertex. NULL if not found.
  */
 Vertex * Graph_searchPersonVertexById(Graph *graph, char *id) {
-    return Graph_binarySearchPersonVertexById(Graph_getVertices(graph),
-        Graph_getVerticesNumber(graph), id);
+    int index = Graph_searchPersonIndexById(graph, id);
+    if (index < 0) {
+        return NULL;
+    }
+    return Graph_getVertices(graph)[index];
+}
+
+/**
+ * @brief Slot of the person hash index.
+ */
+struct person_index_slot {
+    /** Precomputed hash of the id. Only valid if index is not -1. */
+    unsigned int hash;
+    /** The vertex index of the person. -1 if the slot is empty. */
+    int index;
+    /** Offset of the interned id on the index ids blob. */
+    int idOffset;
+};
+typedef struct person_index_slot PersonIndexSlot;
+
+/**
+ * @brief Person index structure.
+ *
+ * Open-addressing hash table, with linear probing, that maps a person id to
+ * its vertex index on the graph. The ids are copied into a single contiguous
+ * blob, so a lookup touches the slot and the interned id only.
+ */
+struct person_index {
+    /** The slots array. Its length is always a power of two. */
+    PersonIndexSlot *slots;
+    /** Length of the slots array minus one, used to wrap the probing. */
+    unsigned int mask;
+    /** All the ids, each one terminated by '\0'. */
+    char *ids;
+    /** Used length of the ids blob. */
+    int idsLength;
+};
+
+/**
+ * @brief Allocates an empty hash index for the given amount of people.
+ *
+ * n: The amount of people.
+ * Complexity: O(n).
+ *
+ * @param length The amount of people.
+ * @param idsLength The length of all the ids, including their terminators.
+ * @return PersonIndex* A pointer to the created index.
+ */
+static PersonIndex * PersonIndex_allocate(int length, size_t idsLength) {
+    unsigned int capacity = 16;
+
+    // Keeps the load factor under 1/2 so probing sequences stay short.
+    while (capacity < (unsigned int) length * 2) {
+        capacity *= 2;
+    }
+
+    PersonIndex *index = (PersonIndex *) malloc(sizeof(PersonIndex));
+    index->slots = (PersonIndexSlot *) malloc(capacity *
+        sizeof(PersonIndexSlot));
+    index->mask = capacity - 1;
+    index->ids = (char *) malloc(idsLength + 1);
+    index->idsLength = 0;
+
+    for (unsigned int i = 0; i < capacity; i += 1) {
+        index->slots[i].index = -1;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Inserts an id on the index, unless it is already there.
+ *
+ * n: The id length.
+ * Complexity: O(n) expected.
+ *
+ * @param index The index.
+ * @param id The person's id.
+ * @param person The person's vertex index.
+ */
+static void PersonIndex_insert(PersonIndex *index, char *id, int person) {
+    unsigned int hash = Hash_id(id);
+    unsigned int position = hash & index->mask;
+
+    while (index->slots[position].index != -1 && !(
+        index->slots[position].hash == hash &&
+        strcmp(index->ids + index->slots[position].idOffset, id) == 0
+    )) {
+        position = (position + 1) & index->mask;
+    }
+
+    if (index->slots[position].index == -1) {
+        int idLength = strlen(id) + 1;
+        memcpy(index->ids + index->idsLength, id, idLength);
+        index->slots[position].hash = hash;
+        index->slots[position].index = person;
+        index->slots[position].idOffset = index->idsLength;
+        index->idsLength += idLength;
+    }
+}
+
+/**
+ * @brief Creates a hash index over the people of the given graph.
+ *
+ * The graph does not need to be sorted, so it replaces both
+ * Graph_sortVerticesByPersonId and the binary search. If two people share the
+ * same id, the first one on the graph is the one indexed.
+ *
+ * n: The graph's vertices number.
+ * Complexity: O(n) expected.
+ *
+ * @param graph The graph.
+ * @return PersonIndex* A pointer to the created index.
+ */
+PersonIndex * PersonIndex_create(Graph *graph) {
+    Vertex **vertices = Graph_getVertices(graph);
+    int length = Graph_getVerticesNumber(graph);
+    size_t idsLength = 0;
+    int i;
+
+    for (i = 0; i < length; i += 1) {
+        idsLength += strlen(((Person *) Vertex_getData(vertices[i]))->id) + 1;
+    }
+
+    PersonIndex *index = PersonIndex_allocate(length, idsLength);
+    for (i = 0; i < length; i += 1) {
+        PersonIndex_insert(index,
+            ((Person *) Vertex_getData(vertices[i]))->id, i);
+    }
+
+    return index;
+}
+
+/**
+ * @brief Creates a hash index over the people of the given table, like
+ * PersonIndex_create.
+ *
+ * n: The amount of people.
+ * Complexity: O(n) expected.
+ *
+ * @param table The table.
+ * @return PersonIndex* A pointer to the created index.
+ */
+PersonIndex * PersonIndex_createFromTable(PersonTable *table) {
+    int length = PersonTable_getLength(table);
+    size_t idsLength = 0;
+    int i;
+
+    for (i = 0; i < length; i += 1) {
+        idsLength += strlen(PersonTable_getId(table, i)) + 1;
+    }
+
+    PersonIndex *index = PersonIndex_allocate(length, idsLength);
+    for (i = 0; i < length; i += 1) {
+        PersonIndex_insert(index, PersonTable_getId(table, i), i);
+    }
+
+    return index;
+}
+
+/**
+ * @brief Destroys the given index. The graph is not modified.
+ *
+ * Complexity: O(1).
+ *
+ * @param index The index to be destroyed.
+ */
+void PersonIndex_destroy(PersonIndex *index) {
+    free(index->slots);
+    free(index->ids);
+    free(index);
+}
+
+/**
+ * @brief Search the person's vertex index given the person id.
+ *
+ * n: The id length.
+ * Complexity: O(n) expected.
+ *
+ * @param index The index.
+ * @param id The person's id.
+ * @return int The person's vertex index on the graph. -1 if not found.
+ */
+int PersonIndex_search(PersonIndex *index, char *id) {
+    unsigned int hash = Hash_id(id);
+    unsigned int position = hash & index->mask;
+
+    METRICS_COUNT(METRICS_INDEX_LOOKUPS);
+    while (index->slots[position].index != -1) {
+        PersonIndexSlot *slot = &index->slots[position];
+        METRICS_COUNT(METRICS_INDEX_PROBES);
+        if (slot->hash == hash &&
+            strcmp(index->ids + slot->idOffset, id) == 0) {
+            return slot->index;
+        }
+        position = (position + 1) & index->mask;
+    }
+
+    return -1;
 }
 
 /**
@@ -117,24 +423,535 @@ Vertex * Graph_searchPersonVertexById(Graph *graph, char *id) {
  */
 void Person_spreadMusic(Vertex *vertex, int* counter) {
     Person *person = (Person *) Vertex_getData(vertex);
-    person->listened = 1;
+    person->listened = spread_epoch;
+    METRICS_ENTER(METRICS_SPREAD_DEPTH);
 
-    if (person->age < 35) {
+    if (person->age < SPREAD_AGE_LIMIT) {
         *counter += 1;
 
         List *edges = Vertex_getEdges(vertex);
         for (int i = 0; i < List_getSize(edges); i += 1) {
-            Vertex *relatedVertex = (Vertex *) List_getItem(edges, i);
+            Vertex *relatedVertex = (Vertex *) List_getItems(edges)[i];
             Person *related = (Person *) Vertex_getData(relatedVertex);
-            if (related->listened == 0) {
+            if (related->listened != spread_epoch) {
                 Person_spreadMusic(relatedVertex, counter);
             }
         }
     }
+    METRICS_LEAVE(METRICS_SPREAD_DEPTH);
 }
 
 /**
- * @brief Destroy all allocated memory for storing people data
+ * @brief Removes the next item of the frontier according to the strategy.
+ *
+ * Complexity: O(1).
+ *
+ * @param frontier The frontier.
+ * @param strategy SPREAD_BFS to use it as a queue, SPREAD_DFS as a stack.
+ * @return void* The removed item.
+ */
+static void * Person_popFrontier(Frontier *frontier, int strategy) {
+    if (strategy == SPREAD_BFS) {
+        return Frontier_popFirst(frontier);
+    }
+    return Frontier_popLast(frontier);
+}
+
+/**
+ * @brief Spread the music hit given the first person's vertex, without
+ * recursion.
+ * 
+ * The vertices to be expanded are kept on an explicit frontier, so the depth
+ * of the graph is not limited by the call stack. A person is marked as
+ * listened when it enters the frontier, so each vertex is stored at most once
+ * and the frontier never holds more than V items. It produces the same counter
+ * and listened marks as Person_spreadMusic.
+ * 
+ * V: The graph's vertices number (program input "n")
+ * E: The graph's edges number (program input "m")
+ * Complexity: O(V+E).
+ * 
+ * @param vertex The person's first vertex who first listened the music.
+ * @param counter Incremented for each person who liked the music.
+ * @param strategy SPREAD_BFS for breadth first, SPREAD_DFS for depth first.
+ */
+void Person_spreadMusicIterative(Vertex *vertex, int *counter, int strategy) {
+    Frontier *frontier = Frontier_create();
+    ((Person *) Vertex_getData(vertex))->listened = spread_epoch;
+    Frontier_push(frontier, vertex);
+
+    while (Frontier_getSize(frontier) > 0) {
+        vertex = (Vertex *) Person_popFrontier(frontier, strategy);
+        Person *person = (Person *) Vertex_getData(vertex);
+
+        if (person->age < SPREAD_AGE_LIMIT) {
+            *counter += 1;
+
+            List *edges = Vertex_getEdges(vertex);
+            int degree = List_getSize(edges);
+            void **neighbors = List_getItems(edges);
+            for (int i = 0; i < degree; i += 1) {
+                Vertex *relatedVertex = (Vertex *) neighbors[i];
+                Person *related = (Person *) Vertex_getData(relatedVertex);
+                if (related->listened != spread_epoch) {
+                    related->listened = spread_epoch;
+                    Frontier_push(frontier, relatedVertex);
+                }
+            }
+        }
+    }
+
+    Frontier_destroy(frontier);
+}
+
+/**
+ * @brief Spread the music hit given the first person's vertex, level by
+ * level, up to the given amount of hops.
+ * 
+ * Breadth first search with the same rules as Person_spreadMusicIterative,
+ * but each level is expanded at once and the people on the last level are
+ * counted and not expanded, so only the neighborhood within the hop limit is
+ * explored. The search stops as soon as a level is empty, whatever maxHops
+ * is. The people who were reached and not expanded are marked as listened.
+ * 
+ * V: The amount of people within maxHops hops.
+ * E: The amount of edges leaving them.
+ * Complexity: O(V+E).
+ * 
+ * @param vertex The person's first vertex who first listened the music.
+ * @param maxHops The amount of hops the music may travel.
+ * @param levels Array with maxHops + 1 positions. Receives how many people
+ * liked the music at each hop, 0 being the first person, up to the first
+ * empty hop, whose count is 0. The later positions are not written.
+ * @return int How many people liked the music within maxHops hops.
+ */
+int Person_spreadMusicLevels(Vertex *vertex, int maxHops, int *levels) {
+    Frontier *frontier = Frontier_create();
+    int counter = 0, hop;
+    ((Person *) Vertex_getData(vertex))->listened = spread_epoch;
+    Frontier_push(frontier, vertex);
+
+    for (hop = 0; hop <= maxHops; hop += 1) {
+        int length = Frontier_getSize(frontier);
+        levels[hop] = 0;
+        if (length == 0) {
+            break;
+        }
+
+        for (int i = 0; i < length; i += 1) {
+            vertex = (Vertex *) Frontier_popFirst(frontier);
+            if (((Person *) Vertex_getData(vertex))->age >= SPREAD_AGE_LIMIT) {
+                continue;
+            }
+            levels[hop] += 1;
+            if (hop == maxHops) {
+                continue;
+            }
+
+            List *edges = Vertex_getEdges(vertex);
+            int degree = List_getSize(edges);
+            void **neighbors = List_getItems(edges);
+            for (int j = 0; j < degree; j += 1) {
+                Vertex *relatedVertex = (Vertex *) neighbors[j];
+                Person *related = (Person *) Vertex_getData(relatedVertex);
+                if (related->listened != spread_epoch) {
+                    related->listened = spread_epoch;
+                    Frontier_push(frontier, relatedVertex);
+                }
+            }
+        }
+        counter += levels[hop];
+    }
+
+    Frontier_destroy(frontier);
+    return counter;
+}
+
+/**
+ * @brief Spread the music hit given the first person's vertex index on a CSR
+ * graph.
+ * 
+ * Same strategy as Person_spreadMusic, but the neighbors are read from the
+ * contiguous CSR arrays by index instead of walking the vertex edges list.
+ * The people data is still read from the vertices of the given graph, which
+ * must have the same indices as the CSR graph.
+ * 
+ * V: The graph's vertices number (program input "n")
+ * E: The graph's edges number (program input "m")
+ * Complexity: O(V+E).
+ * 
+ * @param graph The graph holding the people on its vertices.
+ * @param csr The CSR graph holding the edges.
+ * @param vertex The index of the person who first listened the music.
+ * @param counter Incremented for each person who liked the music.
+ */
+void Person_spreadMusicCsr(Graph *graph, CsrGraph *csr, int vertex,
+    int *counter) {
+    Vertex **vertices = Graph_getVertices(graph);
+    Person *person = (Person *) Vertex_getData(vertices[vertex]);
+    person->listened = spread_epoch;
+    METRICS_ENTER(METRICS_SPREAD_DEPTH);
+
+    if (person->age < SPREAD_AGE_LIMIT) {
+        *counter += 1;
+
+        int degree = CsrGraph_getDegree(csr, vertex);
+        int *neighbors = CsrGraph_getNeighbors(csr, vertex);
+        for (int i = 0; i < degree; i += 1) {
+            Person *related = (Person *) Vertex_getData(vertices[neighbors[i]]);
+            if (related->listened != spread_epoch) {
+                Person_spreadMusicCsr(graph, csr, neighbors[i], counter);
+            }
+        }
+    }
+    METRICS_LEAVE(METRICS_SPREAD_DEPTH);
+}
+
+/**
+ * @brief Spread the music hit given the first person's vertex index on a CSR
+ * graph, without recursion.
+ * 
+ * Same as Person_spreadMusicIterative, but over the CSR graph. The frontier
+ * stores the vertices indices.
+ * 
+ * V: The graph's vertices number (program input "n")
+ * E: The graph's edges number (program input "m")
+ * Complexity: O(V+E).
+ * 
+ * @param graph The graph holding the people on its vertices.
+ * @param csr The CSR graph holding the edges.
+ * @param vertex The index of the person who first listened the music.
+ * @param counter Incremented for each person who liked the music.
+ * @param strategy SPREAD_BFS for breadth first, SPREAD_DFS for depth first.
+ */
+void Person_spreadMusicCsrIterative(Graph *graph, CsrGraph *csr, int vertex,
+    int *counter, int strategy) {
+    Vertex **vertices = Graph_getVertices(graph);
+    Frontier *frontier = Frontier_create();
+    ((Person *) Vertex_getData(vertices[vertex]))->listened = spread_epoch;
+    Frontier_push(frontier, (void *) (intptr_t) vertex);
+
+    while (Frontier_getSize(frontier) > 0) {
+        vertex = (int) (intptr_t) Person_popFrontier(frontier, strategy);
+        Person *person = (Person *) Vertex_getData(vertices[vertex]);
+
+        if (person->age < SPREAD_AGE_LIMIT) {
+            *counter += 1;
+
+            int degree = CsrGraph_getDegree(csr, vertex);
+            int *neighbors = CsrGraph_getNeighbors(csr, vertex);
+            for (int i = 0; i < degree; i += 1) {
+                Person *related = (Person *) Vertex_getData(
+                    vertices[neighbors[i]]);
+                if (related->listened != spread_epoch) {
+                    related->listened = spread_epoch;
+                    Frontier_push(frontier, (void *) (intptr_t) neighbors[i]);
+                }
+            }
+        }
+    }
+
+    Frontier_destroy(frontier);
+}
+
+/**
+ * @brief Spread the music hit given the first person's vertex index on a CSR
+ * graph, level by level, up to the given amount of hops.
+ * 
+ * Same as Person_spreadMusicLevels, but over the CSR graph.
+ * 
+ * V: The amount of people within maxHops hops.
+ * E: The amount of edges leaving them.
+ * Complexity: O(V+E).
+ * 
+ * @param graph The graph holding the people on its vertices.
+ * @param csr The CSR graph holding the edges.
+ * @param vertex The index of the person who first listened the music.
+ * @param maxHops The amount of hops the music may travel.
+ * @param levels Array with maxHops + 1 positions. Receives how many people
+ * liked the music at each hop, 0 being the first person, up to the first
+ * empty hop, whose count is 0. The later positions are not written.
+ * @return int How many people liked the music within maxHops hops.
+ */
+int Person_spreadMusicCsrLevels(Graph *graph, CsrGraph *csr, int vertex,
+    int maxHops, int *levels) {
+    Vertex **vertices = Graph_getVertices(graph);
+    Frontier *frontier = Frontier_create();
+    int counter = 0, hop;
+    ((Person *) Vertex_getData(vertices[vertex]))->listened = spread_epoch;
+    Frontier_push(frontier, (void *) (intptr_t) vertex);
+
+    for (hop = 0; hop <= maxHops; hop += 1) {
+        int length = Frontier_getSize(frontier);
+        levels[hop] = 0;
+        if (length == 0) {
+            break;
+        }
+
+        for (int i = 0; i < length; i += 1) {
+            vertex = (int) (intptr_t) Frontier_popFirst(frontier);
+            Person *person = (Person *) Vertex_getData(vertices[vertex]);
+            if (person->age >= SPREAD_AGE_LIMIT) {
+                continue;
+            }
+            levels[hop] += 1;
+            if (hop == maxHops) {
+                continue;
+            }
+
+            int degree = CsrGraph_getDegree(csr, vertex);
+            int *neighbors = CsrGraph_getNeighbors(csr, vertex);
+            for (int j = 0; j < degree; j += 1) {
+                Person *related = (Person *) Vertex_getData(
+                    vertices[neighbors[j]]);
+                if (related->listened != spread_epoch) {
+                    related->listened = spread_epoch;
+                    Frontier_push(frontier, (void *) (intptr_t) neighbors[j]);
+                }
+            }
+        }
+        counter += levels[hop];
+    }
+
+    Frontier_destroy(frontier);
+    return counter;
+}
+
+/**
+ * @brief Spread the music hit given the first person's vertex index on a
+ * compact graph, without recursion.
+ * 
+ * Same as Person_spreadMusicCsrIterative, but the neighbors are decoded from
+ * the compressed lists while they are visited.
+ * 
+ * V: The graph's vertices number (program input "n")
+ * E: The graph's edges number (program input "m")
+ * Complexity: O(V+E).
+ * 
+ * @param graph The graph holding the people on its vertices.
+ * @param compact The compact graph holding the edges.
+ * @param vertex The index of the person who first listened the music.
+ * @param counter Incremented for each person who liked the music.
+ * @param strategy SPREAD_BFS for breadth first, SPREAD_DFS for depth first.
+ */
+void Person_spreadMusicCompact(Graph *graph, CompactGraph *compact, int vertex,
+    int *counter, int strategy) {
+    Vertex **vertices = Graph_getVertices(graph);
+    Frontier *frontier = Frontier_create();
+    CompactIterator iterator;
+    int related;
+    ((Person *) Vertex_getData(vertices[vertex]))->listened = spread_epoch;
+    Frontier_push(frontier, (void *) (intptr_t) vertex);
+
+    while (Frontier_getSize(frontier) > 0) {
+        vertex = (int) (intptr_t) Person_popFrontier(frontier, strategy);
+        Person *person = (Person *) Vertex_getData(vertices[vertex]);
+
+        if (person->age < SPREAD_AGE_LIMIT) {
+            *counter += 1;
+
+            CompactGraph_iterate(compact, vertex, &iterator);
+            while (CompactGraph_nextNeighbor(&iterator, &related)) {
+                Person *neighbor = (Person *) Vertex_getData(
+                    vertices[related]);
+                if (neighbor->listened != spread_epoch) {
+                    neighbor->listened = spread_epoch;
+                    Frontier_push(frontier, (void *) (intptr_t) related);
+                }
+            }
+        }
+    }
+
+    Frontier_destroy(frontier);
+}
+
+/**
+ * @brief Creates an array with a flag per vertex telling if the spread goes
+ * through its person, that is, if the person is younger than 35.
+ * 
+ * V: The graph's vertices number.
+ * Complexity: O(V).
+ * 
+ * @param graph The graph holding the people on its vertices.
+ * @return unsigned char* The flags. Must be freed by the caller.
+ */
+static unsigned char * Graph_createEligibleFlags(Graph *graph) {
+    Vertex **vertices = Graph_getVertices(graph);
+    int length = Graph_getVerticesNumber(graph);
+    unsigned char *eligible = (unsigned char *) malloc(length + 1);
+
+    for (int i = 0; i < length; i += 1) {
+        eligible[i] = ((Person *) Vertex_getData(vertices[i]))->age <
+            SPREAD_AGE_LIMIT;
+    }
+
+    return eligible;
+}
+
+/**
+ * @brief Context of Person_markListened.
+ */
+struct person_parallel_marks {
+    /** The vertices of the graph holding the people. */
+    Vertex **vertices;
+    /** The CSR graph holding the edges. */
+    CsrGraph *csr;
+};
+typedef struct person_parallel_marks PersonParallelMarks;
+
+/**
+ * @brief Marks a person reached by the parallel search and its neighbors as
+ * listened. Called by several threads at once, which may mark the same
+ * neighbor, so the marks are stored atomically.
+ *
+ * n: The person's degree.
+ * Complexity: O(n).
+ *
+ * @param context The PersonParallelMarks.
+ * @param vertex The index of the reached person.
+ */
+static void Person_markListened(void *context, int vertex) {
+    PersonParallelMarks *marks = (PersonParallelMarks *) context;
+    int degree = CsrGraph_getDegree(marks->csr, vertex);
+    int *neighbors = CsrGraph_getNeighbors(marks->csr, vertex);
+    Person *person = (Person *) Vertex_getData(marks->vertices[vertex]);
+
+    __atomic_store_n(&person->listened, spread_epoch, __ATOMIC_RELAXED);
+    for (int i = 0; i < degree; i += 1) {
+        Person *related = (Person *) Vertex_getData(
+            marks->vertices[neighbors[i]]);
+        __atomic_store_n(&related->listened, spread_epoch, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Creates the parallel search used by Person_spreadMusicParallel. The
+ * people younger than 35 are its eligible vertices.
+ * 
+ * V: The graph's vertices number.
+ * Complexity: O(V).
+ * 
+ * @param graph The graph holding the people on its vertices.
+ * @param csr The CSR graph holding the edges, with the same indices.
+ * @param threads The amount of threads used by each spread.
+ * @return ParallelBfs* The search, reused by all the spreads on the graph.
+ */
+ParallelBfs * Graph_createParallelBfs(Graph *graph, CsrGraph *csr,
+    int threads) {
+    return ParallelBfs_create(csr, Graph_createEligibleFlags(graph), threads);
+}
+
+/**
+ * @brief Spread the music hit given the first person's vertex index on a CSR
+ * graph, using a multithreaded breadth first search.
+ * 
+ * After the search, the worker threads mark the reached people and their
+ * neighbors as listened, so the marks are the same as the ones from
+ * Person_spreadMusic. Nothing proportional to the whole graph runs on a
+ * single thread.
+ * 
+ * V: The graph's vertices number (program input "n")
+ * E: The graph's edges number (program input "m")
+ * Complexity: O(V+E) work, split among the threads.
+ * 
+ * @param graph The graph holding the people on its vertices.
+ * @param csr The CSR graph holding the edges.
+ * @param bfs The search created by Graph_createParallelBfs.
+ * @param vertex The index of the person who first listened the music.
+ * @param counter Incremented for each person who liked the music.
+ */
+void Person_spreadMusicParallel(Graph *graph, CsrGraph *csr, ParallelBfs *bfs,
+    int vertex, int *counter) {
+    PersonParallelMarks marks;
+    marks.vertices = Graph_getVertices(graph);
+    marks.csr = csr;
+
+    ((Person *) Vertex_getData(marks.vertices[vertex]))->listened =
+        spread_epoch;
+    *counter += ParallelBfs_search(bfs, vertex, NULL, Person_markListened,
+        &marks);
+}
+
+/**
+ * @brief Spread the music hit from several first listeners on a CSR graph,
+ * propagating up to 64 of them on each traversal with MultiSpread_run.
+ * 
+ * Each count is the same one Person_spreadMusic would give for that seed
+ * alone, but no one is marked as listened.
+ * 
+ * V: The graph's vertices number (program input "n")
+ * E: The graph's edges number (program input "m")
+ * S: The amount of seeds.
+ * Complexity: O(S/64*(V+E)) for seeds on few components.
+ * 
+ * @param graph The graph holding the people on its vertices.
+ * @param csr The CSR graph holding the edges.
+ * @param seeds The vertex index of each first listener. -1 for missing ones.
+ * @param length The amount of seeds.
+ * @param counts Receives how many people liked the music from each seed.
+ */
+void Person_spreadMusicMulti(Graph *graph, CsrGraph *csr, const int *seeds,
+    int length, int *counts) {
+    unsigned char *eligible = Graph_createEligibleFlags(graph);
+    MultiSpread_run(csr, eligible, seeds, length, counts);
+    free(eligible);
+}
+
+/**
+ * @brief Creates a spread index over the people of the graph, with no edges.
+ * 
+ * After all the edges are inserted with SpreadIndex_insertEdge, using the
+ * graph vertices indices, the index answers how many people would like the
+ * music for any first listener, without marking anyone as listened.
+ * 
+ * V: The graph's vertices number.
+ * Complexity: O(V).
+ * 
+ * @param graph The graph holding the people on its vertices.
+ * @return SpreadIndex* A pointer to the created index.
+ */
+SpreadIndex * Graph_createSpreadIndex(Graph *graph) {
+    unsigned char *eligible = Graph_createEligibleFlags(graph);
+    SpreadIndex *index = SpreadIndex_create(eligible,
+        Graph_getVerticesNumber(graph));
+    free(eligible);
+    return index;
+}
+
+/**
+ * @brief Creates an age index over the people of the graph, with no edges.
+ * 
+ * After all the edges are inserted with AgeIndex_insertEdge, using the graph
+ * vertices indices, and the index is built, it answers how many people would
+ * like the music for any first listener and any age limit.
+ * 
+ * V: The graph's vertices number.
+ * Complexity: O(V).
+ * 
+ * @param graph The graph holding the people on its vertices.
+ * @return AgeIndex* A pointer to the created index, or NULL if it could not
+ * be allocated.
+ */
+AgeIndex * Graph_createAgeIndex(Graph *graph) {
+    Vertex **vertices = Graph_getVertices(graph);
+    int length = Graph_getVerticesNumber(graph);
+    int *ages = (int *) malloc((length + 1) * sizeof(int));
+
+    if (ages == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < length; i += 1) {
+        ages[i] = ((Person *) Vertex_getData(vertices[i]))->age;
+    }
+    AgeIndex *index = AgeIndex_create(ages, length);
+
+    free(ages);
+    return index;
+}
+
+/**
+ * @brief Destroy all allocated memory for storing people data. The vertices
+ * not inserted, after a partial read, are skipped.
  * 
  * V: the graph's vertices number.
  * Complexity: O(V).
@@ -145,6 +962,9 @@ void Graph_destroyPeople(Graph *graph) {
     Vertex **vertices = Graph_getVertices(graph);
     for (int i = 0; i < Graph_getVerticesNumber(graph); i += 1) {
         Vertex *vertex = vertices[i];
+        if (vertex == NULL) {
+            continue;
+        }
         Person *person = (Person *) Vertex_getData(vertex);
         Person_destroy(person);
         Vertex_destroy(vertex);
@@ -208,4 +1028,43 @@ static void Graph_quickSortVerticesByPersonId (Vertex **vertices, int length) {
 void Graph_sortVerticesByPersonId(Graph *graph) {
     Graph_quickSortVerticesByPersonId(Graph_getVertices(graph),
         Graph_getVerticesNumber(graph));
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Sort the vertices array based on the people id, like
+ * Graph_sortVerticesByPersonId, using the parallel multikey sort of IdSort.
+ *
+ * The ids are copied to a contiguous array once, so the sort never follows
+ * the vertex and person pointers, and the people are moved to their final
+ * vertices at the end.
+ *
+ * n: vertices length
+ * L: ids length
+ * Complexity: O(n*log(n) + n*L/8) expected, split among the threads.
+ *
+ * @param graph The graph, without edges.
+ * @param threads The amount of threads to be used.
+ */
+void Graph_sortVerticesByPersonIdMultikey(Graph *graph, int threads) {
+    Vertex **vertices = Graph_getVertices(graph);
+    int length = Graph_getVerticesNumber(graph);
+    Person **people = (Person **) malloc((length + 1) * sizeof(Person *));
+    char **ids = (char **) malloc((length + 1) * sizeof(char *));
+    int *order = (int *) malloc((length + 1) * sizeof(int));
+    int i;
+
+    for (i = 0; i < length; i += 1) {
+        people[i] = (Person *) Vertex_getData(vertices[i]);
+        ids[i] = people[i]->id;
+    }
+
+    IdSort_sort(ids, length, threads, order);
+
+    for (i = 0; i < length; i += 1) {
+        Vertex_setData(vertices[i], people[order[i]]);
+    }
+
+    free(people);
+    free(ids);
+    free(order);
+}
@@ -1,22 +1,91 @@
 #include "graph.h"
+#include "csr_graph.h"
+#include "compact_graph.h"
+#include "parallel_bfs.h"
+#include "arena.h"
+#include "spread_index.h"
+#include "age_index.h"
+#include "person_table.h"
 
 #ifndef PERSON_H
 #define PERSON_H
 
-#define MAX_ID_LENGTH 256
+/** The music only spreads through people younger than this age. */
+#define SPREAD_AGE_LIMIT 35
+
+/** Spread strategies for the iterative traversals. */
+#define SPREAD_DFS 0
+#define SPREAD_BFS 1
+
+/** Sort algorithms for the people ids. */
+#define SORT_QUICKSORT 0
+#define SORT_MULTIKEY 1
 
 typedef struct person Person;
 
+typedef struct person_index PersonIndex;
+
 Person * Person_create(char *id, int age);
 
+Person * Person_createInArena(Arena *arena, char *id, int age);
+
+char * Person_getId(Person *person);
+
+int Person_getAge(Person *person);
+
+void Person_setAge(Person *person, int age);
+
 void Person_destroy(void *person);
 
+void Person_resetSpread();
+
+int Graph_searchPersonIndexById(Graph *graph, char *id);
+
 Vertex * Graph_searchPersonVertexById(Graph *graph, char *id);
 
+PersonIndex * PersonIndex_create(Graph *graph);
+
+PersonIndex * PersonIndex_createFromTable(PersonTable *table);
+
+void PersonIndex_destroy(PersonIndex *index);
+
+int PersonIndex_search(PersonIndex *index, char *id);
+
 void Person_spreadMusic(Vertex *vertex, int* counter);
 
+void Person_spreadMusicIterative(Vertex *vertex, int *counter, int strategy);
+
+int Person_spreadMusicLevels(Vertex *vertex, int maxHops, int *levels);
+
+void Person_spreadMusicCsr(Graph *graph, CsrGraph *csr, int vertex,
+    int *counter);
+
+void Person_spreadMusicCsrIterative(Graph *graph, CsrGraph *csr, int vertex,
+    int *counter, int strategy);
+
+int Person_spreadMusicCsrLevels(Graph *graph, CsrGraph *csr, int vertex,
+    int maxHops, int *levels);
+
+void Person_spreadMusicCompact(Graph *graph, CompactGraph *compact, int vertex,
+    int *counter, int strategy);
+
+ParallelBfs * Graph_createParallelBfs(Graph *graph, CsrGraph *csr,
+    int threads);
+
+void Person_spreadMusicParallel(Graph *graph, CsrGraph *csr, ParallelBfs *bfs,
+    int vertex, int *counter);
+
+void Person_spreadMusicMulti(Graph *graph, CsrGraph *csr, const int *seeds,
+    int length, int *counts);
+
+SpreadIndex * Graph_createSpreadIndex(Graph *graph);
+
+AgeIndex * Graph_createAgeIndex(Graph *graph);
+
 void Graph_destroyPeople(Graph *graph);
 
 void Graph_sortVerticesByPersonId(Graph *graph);
 
+void Graph_sortVerticesByPersonIdMultikey(Graph *graph, int threads);
+
 #endif
\ No newline at end of file
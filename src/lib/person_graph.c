@@ -0,0 +1,413 @@
+#include <stdlib.h>
+#include <string.h>
+#include "person_graph.h"
+#include "graph.h"
+#include "input.h"
+#include "person.h"
+#include "hash.h"
+
+/**
+ * @brief Initial capacity of the ids table.
+ */
+#define PERSON_GRAPH_INITIAL_CAPACITY 16
+
+/**
+ * @brief Slot of the person graph ids table.
+ */
+struct person_graph_slot {
+    /** Precomputed hash of the id. Only valid if vertex is not -1. */
+    unsigned int hash;
+    /** The vertex index of the person. -1 if the slot is empty. */
+    int vertex;
+};
+typedef struct person_graph_slot PersonGraphSlot;
+
+/**
+ * @brief Person graph structure.
+ *
+ * Mutable graph of people, stored on a DinamicGraph whose vertices hold the
+ * people. The people are found by id on an open addressing table, with
+ * linear probing and removal by backward shifting, so inserting, removing and
+ * finding people and edges cost O(1) expected, and a delta is applied without
+ * reloading the whole graph. The ids are copied, so they belong to the graph.
+ */
+struct person_graph {
+    /** The graph, holding a Person on each vertex. */
+    DinamicGraph *graph;
+    /** The ids table. Its length is always a power of two. */
+    PersonGraphSlot *slots;
+    /** Length of the ids table minus one, used to wrap the probing. */
+    unsigned int mask;
+    /** Spread epoch on which each vertex was reached. */
+    int *listened;
+    /** Allocated length of the listened array. */
+    int listenedCapacity;
+    /** Current spread epoch. */
+    int epoch;
+    /** Stack used by the spread. */
+    int *stack;
+};
+
+/**
+ * @brief Gives the home slot of the id held by the ids table slot, or -1 if
+ * the slot is empty.
+ */
+static long PersonGraph_slotHome(void *context, const void *slot) {
+    const PersonGraphSlot *idSlot = (const PersonGraphSlot *) slot;
+    if (idSlot->vertex == -1) {
+        return -1;
+    }
+    return idSlot->hash & ((PersonGraph *) context)->mask;
+}
+
+/**
+ * @brief Allocates an empty ids table with the given length.
+ */
+static void PersonGraph_allocateSlots(PersonGraph *graph,
+    unsigned int length) {
+    graph->slots = (PersonGraphSlot *) malloc(length *
+        sizeof(PersonGraphSlot));
+    graph->mask = length - 1;
+    for (unsigned int i = 0; i < length; i += 1) {
+        graph->slots[i].vertex = -1;
+    }
+}
+
+/**
+ * @brief Creates an empty person graph.
+ *
+ * Complexity: O(1).
+ *
+ * @return PersonGraph* A pointer to the created graph.
+ */
+PersonGraph * PersonGraph_create() {
+    PersonGraph *graph = (PersonGraph *) malloc(sizeof(PersonGraph));
+    graph->graph = DinamicGraph_create();
+    PersonGraph_allocateSlots(graph, PERSON_GRAPH_INITIAL_CAPACITY);
+    graph->listened = NULL;
+    graph->listenedCapacity = 0;
+    graph->epoch = 0;
+    graph->stack = NULL;
+    return graph;
+}
+
+/**
+ * @brief Destroys the given graph and all its people.
+ *
+ * n: The amount of vertices slots.
+ * Complexity: O(n).
+ *
+ * @param graph The graph to be destroyed.
+ */
+void PersonGraph_destroy(PersonGraph *graph) {
+    for (int i = 0; i < DinamicGraph_getSlotsNumber(graph->graph); i += 1) {
+        if (DinamicGraph_hasVertex(graph->graph, i)) {
+            Person *person = (Person *) DinamicGraph_getData(graph->graph, i);
+            free(Person_getId(person));
+            Person_destroy(person);
+        }
+    }
+    DinamicGraph_destroy(graph->graph);
+    free(graph->slots);
+    free(graph->listened);
+    free(graph->stack);
+    free(graph);
+}
+
+/**
+ * @brief Getter for the underlying graph. Its vertices hold the people.
+ *
+ * Complexity: O(1).
+ *
+ * @param graph The person graph.
+ * @return DinamicGraph* The graph.
+ */
+DinamicGraph * PersonGraph_getGraph(PersonGraph *graph) {
+    return graph->graph;
+}
+
+/**
+ * @brief Finds the ids table slot of the given id.
+ *
+ * n: The id length.
+ * Complexity: O(n) expected.
+ *
+ * @param graph The graph.
+ * @param id The id.
+ * @param hash The id hash.
+ * @return unsigned int The slot holding the id, or the empty slot where it
+ * would be inserted.
+ */
+static unsigned int PersonGraph_findSlot(PersonGraph *graph, char *id,
+    unsigned int hash) {
+    unsigned int position = hash & graph->mask;
+
+    while (graph->slots[position].vertex != -1) {
+        PersonGraphSlot *slot = &graph->slots[position];
+        if (slot->hash == hash && strcmp(Person_getId((Person *)
+            DinamicGraph_getData(graph->graph, slot->vertex)), id) == 0) {
+            break;
+        }
+        position = (position + 1) & graph->mask;
+    }
+
+    return position;
+}
+
+/**
+ * @brief Search the person's vertex index given the person id.
+ *
+ * n: The id length.
+ * Complexity: O(n) expected.
+ *
+ * @param graph The graph.
+ * @param id The person's id.
+ * @return int The person's vertex index. -1 if not found.
+ */
+int PersonGraph_search(PersonGraph *graph, char *id) {
+    return graph->slots[PersonGraph_findSlot(graph, id,
+        Hash_id(id))].vertex;
+}
+
+/**
+ * @brief Doubles the ids table, inserting all the people again.
+ *
+ * n: The amount of people.
+ * Complexity: O(n).
+ *
+ * @param graph The graph.
+ */
+static void PersonGraph_growSlots(PersonGraph *graph) {
+    PersonGraphSlot *slots = graph->slots;
+    unsigned int length = graph->mask + 1;
+
+    PersonGraph_allocateSlots(graph, length * 2);
+    for (unsigned int i = 0; i < length; i += 1) {
+        unsigned int position = slots[i].hash & graph->mask;
+        if (slots[i].vertex == -1) {
+            continue;
+        }
+        while (graph->slots[position].vertex != -1) {
+            position = (position + 1) & graph->mask;
+        }
+        graph->slots[position] = slots[i];
+    }
+
+    free(slots);
+}
+
+/**
+ * @brief Inserts a person on the graph, with no relationships. If there is
+ * already a person with the same id, only its age is updated.
+ *
+ * n: The id length.
+ * Complexity: O(n) amortized.
+ *
+ * @param graph The graph.
+ * @param id The person id. It is copied.
+ * @param age The person age.
+ * @return int The person's vertex index.
+ */
+int PersonGraph_insertPerson(PersonGraph *graph, char *id, int age) {
+    unsigned int hash = Hash_id(id);
+    unsigned int position = PersonGraph_findSlot(graph, id, hash);
+
+    if (graph->slots[position].vertex != -1) {
+        int vertex = graph->slots[position].vertex;
+        Person_setAge((Person *) DinamicGraph_getData(graph->graph, vertex),
+            age);
+        return vertex;
+    }
+
+    // Keeps the load factor under 1/2 so probing sequences stay short.
+    if ((unsigned int) (DinamicGraph_getVerticesNumber(graph->graph) + 1) * 2 >
+        graph->mask + 1) {
+        PersonGraph_growSlots(graph);
+        position = PersonGraph_findSlot(graph, id, hash);
+    }
+
+    size_t idLength = strlen(id) + 1;
+    char *copy = (char *) malloc(idLength);
+    memcpy(copy, id, idLength);
+
+    graph->slots[position].hash = hash;
+    graph->slots[position].vertex = DinamicGraph_insertVertex(graph->graph,
+        Person_create(copy, age));
+    return graph->slots[position].vertex;
+}
+
+/**
+ * @brief Removes the person with the given id and all their relationships.
+ *
+ * n: The id length.
+ * d: The person degree.
+ * Complexity: O(n+d) expected.
+ *
+ * @param graph The graph.
+ * @param id The person's id.
+ * @return int 1 if the person was removed, 0 if not found.
+ */
+int PersonGraph_removePerson(PersonGraph *graph, char *id) {
+    unsigned int position = PersonGraph_findSlot(graph, id,
+        Hash_id(id));
+    if (graph->slots[position].vertex == -1) {
+        return 0;
+    }
+
+    Person *person = (Person *) DinamicGraph_removeVertex(graph->graph,
+        graph->slots[position].vertex);
+    free(Person_getId(person));
+    Person_destroy(person);
+
+    position = Hash_eraseSlot(graph->slots, sizeof(PersonGraphSlot),
+        graph->mask, position, PersonGraph_slotHome, graph);
+    graph->slots[position].vertex = -1;
+
+    return 1;
+}
+
+/**
+ * @brief Sets a relationship between the people with the given ids.
+ *
+ * n: The ids length.
+ * Complexity: O(n) amortized.
+ *
+ * @param graph The graph.
+ * @param id1 The first person's id.
+ * @param id2 The second person's id.
+ * @return int 1 if the relationship was inserted, 0 if a person was not found
+ * or they were already related.
+ */
+int PersonGraph_insertEdge(PersonGraph *graph, char *id1, char *id2) {
+    int vertex1 = PersonGraph_search(graph, id1);
+    int vertex2 = PersonGraph_search(graph, id2);
+    if (vertex1 < 0 || vertex2 < 0) {
+        return 0;
+    }
+    return DinamicGraph_insertEdge(graph->graph, vertex1, vertex2);
+}
+
+/**
+ * @brief Removes the relationship between the people with the given ids.
+ *
+ * n: The ids length.
+ * Complexity: O(n) expected.
+ *
+ * @param graph The graph.
+ * @param id1 The first person's id.
+ * @param id2 The second person's id.
+ * @return int 1 if the relationship was removed, 0 if it was not found.
+ */
+int PersonGraph_removeEdge(PersonGraph *graph, char *id1, char *id2) {
+    int vertex1 = PersonGraph_search(graph, id1);
+    int vertex2 = PersonGraph_search(graph, id2);
+    if (vertex1 < 0 || vertex2 < 0) {
+        return 0;
+    }
+    return DinamicGraph_removeEdge(graph->graph, vertex1, vertex2);
+}
+
+/**
+ * @brief Applies the updates read from the input until it ends. Each update
+ * is one of:
+ * - "+person ID AGE": inserts the person, or updates their age;
+ * - "-person ID": removes the person and their relationships;
+ * - "+edge ID1 ID2": relates the people;
+ * - "-edge ID1 ID2": removes the relationship.
+ * Updates referencing unknown people are ignored.
+ *
+ * n: The input length.
+ * Complexity: O(n) expected.
+ *
+ * @param graph The graph.
+ * @param input The input.
+ * @return int The amount of updates read, or -1 if an update is invalid. The
+ * updates before the invalid one are kept.
+ */
+int PersonGraph_applyUpdates(PersonGraph *graph, Input *input) {
+    int updates = 0;
+    char *operation;
+
+    while ((operation = Input_nextToken(input, NULL)) != NULL) {
+        char *id1 = Input_nextToken(input, NULL);
+        char *id2 = NULL;
+        int age = 0;
+        if (id1 == NULL) {
+            return -1;
+        }
+
+        if (strcmp(operation, "+person") == 0) {
+            if (!Input_nextInt(input, &age)) {
+                return -1;
+            }
+            PersonGraph_insertPerson(graph, id1, age);
+        } else if (strcmp(operation, "-person") == 0) {
+            PersonGraph_removePerson(graph, id1);
+        } else if (strcmp(operation, "+edge") == 0 &&
+            (id2 = Input_nextToken(input, NULL)) != NULL) {
+            PersonGraph_insertEdge(graph, id1, id2);
+        } else if (strcmp(operation, "-edge") == 0 &&
+            (id2 = Input_nextToken(input, NULL)) != NULL) {
+            PersonGraph_removeEdge(graph, id1, id2);
+        } else {
+            return -1;
+        }
+        updates += 1;
+    }
+
+    return updates;
+}
+
+/**
+ * @brief Spread the music hit given the first person's vertex index, with the
+ * same rules as Person_spreadMusic, without recursion.
+ *
+ * The listened marks are epoch stamps kept by the graph, so consecutive
+ * spreads do not need to clear them.
+ *
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * Complexity: O(V+E).
+ *
+ * @param graph The graph.
+ * @param vertex The index of the person who first listened the music.
+ * @return int How many people liked the music.
+ */
+int PersonGraph_spreadMusic(PersonGraph *graph, int vertex) {
+    int slots = DinamicGraph_getSlotsNumber(graph->graph);
+    int size = 0, counter = 0;
+
+    if (graph->listenedCapacity < slots) {
+        free(graph->listened);
+        free(graph->stack);
+        graph->listenedCapacity = slots;
+        graph->listened = (int *) calloc(slots, sizeof(int));
+        graph->stack = (int *) malloc(slots * sizeof(int));
+    }
+
+    int *listened = graph->listened;
+    int *stack = graph->stack;
+    int epoch = ++graph->epoch;
+
+    listened[vertex] = epoch;
+    stack[size++] = vertex;
+    while (size > 0) {
+        vertex = stack[--size];
+        Person *person = (Person *) DinamicGraph_getData(graph->graph, vertex);
+        if (Person_getAge(person) >= SPREAD_AGE_LIMIT) {
+            continue;
+        }
+        counter += 1;
+
+        int degree = DinamicGraph_getDegree(graph->graph, vertex);
+        int *neighbors = DinamicGraph_getNeighbors(graph->graph, vertex);
+        for (int i = 0; i < degree; i += 1) {
+            if (listened[neighbors[i]] != epoch) {
+                listened[neighbors[i]] = epoch;
+                stack[size++] = neighbors[i];
+            }
+        }
+    }
+
+    return counter;
+}
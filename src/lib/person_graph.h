@@ -0,0 +1,29 @@
+#include "graph.h"
+#include "input.h"
+
+#ifndef PERSON_GRAPH_H
+#define PERSON_GRAPH_H
+
+typedef struct person_graph PersonGraph;
+
+PersonGraph * PersonGraph_create();
+
+void PersonGraph_destroy(PersonGraph *graph);
+
+DinamicGraph * PersonGraph_getGraph(PersonGraph *graph);
+
+int PersonGraph_search(PersonGraph *graph, char *id);
+
+int PersonGraph_insertPerson(PersonGraph *graph, char *id, int age);
+
+int PersonGraph_removePerson(PersonGraph *graph, char *id);
+
+int PersonGraph_insertEdge(PersonGraph *graph, char *id1, char *id2);
+
+int PersonGraph_removeEdge(PersonGraph *graph, char *id1, char *id2);
+
+int PersonGraph_applyUpdates(PersonGraph *graph, Input *input);
+
+int PersonGraph_spreadMusic(PersonGraph *graph, int vertex);
+
+#endif
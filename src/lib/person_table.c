@@ -0,0 +1,573 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "person_table.h"
+#include "csr_graph.h"
+#include "compact_graph.h"
+#include "parallel_bfs.h"
+#include "person.h"
+#include "id_sort.h"
+#include "metrics.h"
+#include "multi_spread.h"
+
+/**
+ * @brief Initial capacity of the ids blob, in bytes.
+ */
+#define PERSON_TABLE_INITIAL_IDS_CAPACITY 4096
+
+/**
+ * @brief Person table structure.
+ *
+ * The people are stored as a struct of arrays and referenced by their integer
+ * index, the same one used by the CSR graph. The ids are interned on a single
+ * blob, each one terminated by '\0', so a person costs an age, an id offset,
+ * a listened bit and its id bytes, with no allocation per person. The spread
+ * only reads the ages and the listened bits, which stay small enough to be
+ * kept on the cache.
+ */
+struct person_table {
+    /** The amount of people. */
+    int length;
+    /** Allocated amount of people. */
+    int capacity;
+    /** Age of each person. */
+    int *ages;
+    /** Start of each id on the blob, with length + 1 positions. */
+    int64_t *idOffsets;
+    /** All the ids, each one terminated by '\0'. */
+    char *ids;
+    /** Allocated length of the ids blob. */
+    size_t idsCapacity;
+    /** Bitset with the people who listened to the music. */
+    unsigned long long *listened;
+    /** Frontier of the spread, with one position per person. */
+    int *frontier;
+    /** If 0, the ages, offsets and ids belong to someone else. */
+    int ownsArrays;
+};
+
+/**
+ * @brief Creates an empty person table.
+ *
+ * Complexity: O(n), being n the capacity.
+ *
+ * @param capacity The maximum amount of people.
+ * @return PersonTable* A pointer to the created table.
+ */
+PersonTable * PersonTable_create(int capacity) {
+    PersonTable *table = (PersonTable *) malloc(sizeof(PersonTable));
+    table->length = 0;
+    table->capacity = capacity;
+    table->ages = (int *) malloc((capacity + 1) * sizeof(int));
+    table->idOffsets = (int64_t *) malloc((capacity + 1) * sizeof(int64_t));
+    table->idOffsets[0] = 0;
+    table->idsCapacity = PERSON_TABLE_INITIAL_IDS_CAPACITY;
+    table->ids = (char *) malloc(table->idsCapacity);
+    table->listened = (unsigned long long *) calloc(
+        PARALLEL_BFS_WORDS(capacity) + 1, sizeof(unsigned long long));
+    table->frontier = (int *) malloc((capacity + 1) * sizeof(int));
+    table->ownsArrays = 1;
+    return table;
+}
+
+/**
+ * @brief Creates a full person table over arrays owned by the caller, such as
+ * a mapped snapshot. Only the spread marks are allocated.
+ *
+ * Complexity: O(n), being n the length.
+ *
+ * @param length The amount of people.
+ * @param ages Age of each person.
+ * @param idOffsets Start of each id on the blob, with length + 1 positions.
+ * @param ids The ids blob, each one terminated by '\0'.
+ * @return PersonTable* A pointer to the created table.
+ */
+PersonTable * PersonTable_createView(int length, int *ages,
+    int64_t *idOffsets, char *ids) {
+    PersonTable *table = (PersonTable *) malloc(sizeof(PersonTable));
+    table->length = length;
+    table->capacity = length;
+    table->ages = ages;
+    table->idOffsets = idOffsets;
+    table->ids = ids;
+    table->idsCapacity = idOffsets[length];
+    table->listened = (unsigned long long *) calloc(
+        PARALLEL_BFS_WORDS(length) + 1, sizeof(unsigned long long));
+    table->frontier = (int *) malloc((length + 1) * sizeof(int));
+    table->ownsArrays = 0;
+    return table;
+}
+
+/**
+ * @brief Destroys the given table and its arrays.
+ *
+ * Complexity: O(1).
+ *
+ * @param table The table to be destroyed.
+ */
+void PersonTable_destroy(PersonTable *table) {
+    if (table->ownsArrays) {
+        free(table->ages);
+        free(table->idOffsets);
+        free(table->ids);
+    }
+    free(table->listened);
+    free(table->frontier);
+    free(table);
+}
+
+/**
+ * @brief Getter for the amount of people.
+ *
+ * Complexity: O(1).
+ *
+ * @param table The table.
+ * @return int The amount of people.
+ */
+int PersonTable_getLength(PersonTable *table) {
+    return table->length;
+}
+
+/**
+ * @brief Appends a person to the table, copying its id into the blob.
+ *
+ * n: The id length.
+ * Complexity: O(n) amortized.
+ *
+ * @param table The table, with less people than its capacity.
+ * @param id The person id.
+ * @param age The person age.
+ * @return int The index of the person.
+ */
+int PersonTable_insert(PersonTable *table, char *id, int age) {
+    int person = table->length;
+    size_t idLength = strlen(id) + 1;
+    size_t offset = table->idOffsets[person];
+
+    while (offset + idLength > table->idsCapacity) {
+        table->idsCapacity *= 2;
+        table->ids = (char *) realloc(table->ids, table->idsCapacity);
+    }
+
+    memcpy(table->ids + offset, id, idLength);
+    table->ages[person] = age;
+    table->idOffsets[person + 1] = offset + idLength;
+    table->length += 1;
+    return person;
+}
+
+/**
+ * @brief Creates a copy of the table with the people in the given order, so
+ * the person order[i] becomes the person i. The copy is not sorted by id.
+ *
+ * n: The amount of people.
+ * L: The ids total length.
+ * Complexity: O(n+L).
+ *
+ * @param table The table.
+ * @param order The old index of each new position.
+ * @return PersonTable* The reordered table.
+ */
+PersonTable * PersonTable_createPermuted(PersonTable *table,
+    const int *order) {
+    PersonTable *permuted = PersonTable_create(table->length);
+
+    for (int i = 0; i < table->length; i += 1) {
+        PersonTable_insert(permuted, PersonTable_getId(table, order[i]),
+            table->ages[order[i]]);
+    }
+
+    return permuted;
+}
+
+/**
+ * @brief Getter for the id of the given person.
+ *
+ * Complexity: O(1).
+ *
+ * @param table The table.
+ * @param person The person index.
+ * @return char* The interned id.
+ */
+char * PersonTable_getId(PersonTable *table, int person) {
+    return table->ids + table->idOffsets[person];
+}
+
+/**
+ * @brief Getter for the age of the given person.
+ *
+ * Complexity: O(1).
+ *
+ * @param table The table.
+ * @param person The person index.
+ * @return int The person age.
+ */
+int PersonTable_getAge(PersonTable *table, int person) {
+    return table->ages[person];
+}
+
+/**
+ * @brief Table being sorted, used by the sort comparison.
+ */
+static PersonTable *person_table_sorting;
+
+/**
+ * @brief Compares two people indices by their ids.
+ */
+static int PersonTable_compareIds(const void *a, const void *b) {
+    return strcmp(PersonTable_getId(person_table_sorting, *(const int *) a),
+        PersonTable_getId(person_table_sorting, *(const int *) b));
+}
+
+/**
+ * @brief Sorts the people by id, so they can be found with
+ * PersonTable_searchId. The people indices change, so it must be called
+ * before any edge is stored.
+ *
+ * The indices are sorted and then the arrays are rebuilt on the new order,
+ * so each id is moved once. Both algorithms give the same order.
+ *
+ * n: The amount of people.
+ * Complexity: O(n*log(n)).
+ *
+ * @param table The table, which must own its arrays.
+ * @param algorithm SORT_QUICKSORT for the C library sort, SORT_MULTIKEY for
+ * the parallel multikey sort of IdSort.
+ * @param threads The amount of threads of the multikey sort.
+ */
+void PersonTable_sortById(PersonTable *table, int algorithm, int threads) {
+    int length = table->length;
+    int *order = (int *) malloc((length + 1) * sizeof(int));
+    int *ages = (int *) malloc((table->capacity + 1) * sizeof(int));
+    int64_t *idOffsets = (int64_t *) malloc((table->capacity + 1) *
+        sizeof(int64_t));
+    char *ids = (char *) malloc(table->idsCapacity);
+    int i;
+
+    if (algorithm == SORT_MULTIKEY) {
+        char **sortIds = (char **) malloc((length + 1) * sizeof(char *));
+        for (i = 0; i < length; i += 1) {
+            sortIds[i] = PersonTable_getId(table, i);
+        }
+        IdSort_sort(sortIds, length, threads, order);
+        free(sortIds);
+    } else {
+        for (i = 0; i < length; i += 1) {
+            order[i] = i;
+        }
+        person_table_sorting = table;
+        qsort(order, length, sizeof(int), PersonTable_compareIds);
+    }
+
+    idOffsets[0] = 0;
+    for (i = 0; i < length; i += 1) {
+        size_t idLength = table->idOffsets[order[i] + 1] -
+            table->idOffsets[order[i]];
+        memcpy(ids + idOffsets[i], PersonTable_getId(table, order[i]),
+            idLength);
+        ages[i] = table->ages[order[i]];
+        idOffsets[i + 1] = idOffsets[i] + idLength;
+    }
+
+    free(order);
+    free(table->ages);
+    free(table->idOffsets);
+    free(table->ids);
+    table->ages = ages;
+    table->idOffsets = idOffsets;
+    table->ids = ids;
+}
+
+/**
+ * @brief Search the person index given the person id, using the binary
+ * search over the sorted table.
+ *
+ * n: The amount of people.
+ * Complexity: O(log(n)).
+ *
+ * @param table The table, sorted by id.
+ * @param id The person's id.
+ * @return int The person index. -1 if not found.
+ */
+int PersonTable_searchId(PersonTable *table, char *id) {
+    int left = 0, right = table->length - 1;
+
+    while (left <= right) {
+        int middle = left + (right - left) / 2;
+        int comparison = strcmp(id, PersonTable_getId(table, middle));
+        METRICS_COUNT(METRICS_SEARCH_COMPARISONS);
+        if (comparison == 0) {
+            return middle;
+        }
+        if (comparison > 0) {
+            left = middle + 1;
+        } else {
+            right = middle - 1;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Creates an array with a flag per person telling if the spread goes
+ * through it, that is, if the person is younger than SPREAD_AGE_LIMIT.
+ *
+ * n: The amount of people.
+ * Complexity: O(n).
+ *
+ * @param table The table.
+ * @return unsigned char* The flags. Must be freed by the caller.
+ */
+unsigned char * PersonTable_createEligibleFlags(PersonTable *table) {
+    unsigned char *eligible = (unsigned char *) malloc(table->length + 1);
+
+    for (int i = 0; i < table->length; i += 1) {
+        eligible[i] = table->ages[i] < SPREAD_AGE_LIMIT;
+    }
+
+    return eligible;
+}
+
+/**
+ * @brief Resets the listened marks of all people, so a new spread can run on
+ * the same table.
+ *
+ * n: The amount of people.
+ * Complexity: O(n/64).
+ *
+ * @param table The table.
+ */
+void PersonTable_resetSpread(PersonTable *table) {
+    memset(table->listened, 0, PARALLEL_BFS_WORDS(table->length) *
+        sizeof(unsigned long long));
+}
+
+/**
+ * @brief Spread the music hit given the first person's index on a CSR graph
+ * with the same indices as the table, without recursion.
+ *
+ * Same rules as Person_spreadMusicCsrIterative, but the people data is read
+ * from the dense ages array and the listened bitset. The frontier is a
+ * plain array: a person is marked when it enters it, so it never holds more
+ * than one position per person.
+ *
+ * V: The graph's vertices number (program input "n")
+ * E: The graph's edges number (program input "m")
+ * Complexity: O(V+E).
+ *
+ * @param table The table holding the people.
+ * @param csr The CSR graph holding the edges.
+ * @param person The index of the person who first listened the music.
+ * @param strategy SPREAD_BFS for breadth first, SPREAD_DFS for depth first.
+ * @return int How many people liked the music.
+ */
+int PersonTable_spreadMusic(PersonTable *table, CsrGraph *csr, int person,
+    int strategy) {
+    unsigned long long *listened = table->listened;
+    int *frontier = table->frontier;
+    int *ages = table->ages;
+    int first = 0, size = 0, counter = 0;
+
+    listened[person / 64] |= 1ULL << (person % 64);
+    frontier[size++] = person;
+    while (size > first) {
+        person = strategy == SPREAD_BFS ? frontier[first++] : frontier[--size];
+        if (ages[person] >= SPREAD_AGE_LIMIT) {
+            continue;
+        }
+        counter += 1;
+
+        int degree = CsrGraph_getDegree(csr, person);
+        int *neighbors = CsrGraph_getNeighbors(csr, person);
+        for (int i = 0; i < degree; i += 1) {
+            int related = neighbors[i];
+            unsigned long long bit = 1ULL << (related % 64);
+            if (!(listened[related / 64] & bit)) {
+                listened[related / 64] |= bit;
+                frontier[size++] = related;
+            }
+        }
+    }
+
+    return counter;
+}
+
+/**
+ * @brief Spread the music hit given the first person's index on a CSR graph
+ * with the same indices as the table, level by level, up to the given amount
+ * of hops.
+ *
+ * Same rules as Person_spreadMusicLevels. The frontier array holds every
+ * person marked, so the marks are cleared from it afterwards instead of by
+ * PersonTable_resetSpread: a bounded query costs only the neighborhood it
+ * explored, whatever the table length is.
+ *
+ * V: The amount of people within maxHops hops.
+ * E: The amount of edges leaving them.
+ * Complexity: O(V+E).
+ *
+ * @param table The table holding the people, with no one marked.
+ * @param csr The CSR graph holding the edges.
+ * @param person The index of the person who first listened the music.
+ * @param maxHops The amount of hops the music may travel.
+ * @param levels Array with maxHops + 1 positions. Receives how many people
+ * liked the music at each hop, 0 being the first person, up to the first
+ * empty hop, whose count is 0. The later positions are not written.
+ * @return int How many people liked the music within maxHops hops.
+ */
+int PersonTable_spreadMusicLevels(PersonTable *table, CsrGraph *csr,
+    int person, int maxHops, int *levels) {
+    unsigned long long *listened = table->listened;
+    int *frontier = table->frontier;
+    int *ages = table->ages;
+    int first = 0, size = 0, counter = 0, hop, i;
+
+    listened[person / 64] |= 1ULL << (person % 64);
+    frontier[size++] = person;
+    for (hop = 0; hop <= maxHops; hop += 1) {
+        int last = size;
+        levels[hop] = 0;
+        if (first == last) {
+            break;
+        }
+
+        for (; first < last; first += 1) {
+            person = frontier[first];
+            if (ages[person] >= SPREAD_AGE_LIMIT) {
+                continue;
+            }
+            levels[hop] += 1;
+            if (hop == maxHops) {
+                continue;
+            }
+
+            int degree = CsrGraph_getDegree(csr, person);
+            int *neighbors = CsrGraph_getNeighbors(csr, person);
+            for (i = 0; i < degree; i += 1) {
+                int related = neighbors[i];
+                unsigned long long bit = 1ULL << (related % 64);
+                if (!(listened[related / 64] & bit)) {
+                    listened[related / 64] |= bit;
+                    frontier[size++] = related;
+                }
+            }
+        }
+        counter += levels[hop];
+    }
+
+    for (i = 0; i < size; i += 1) {
+        listened[frontier[i] / 64] = 0;
+    }
+
+    return counter;
+}
+
+/**
+ * @brief Spread the music hit given the first person's index on a compact
+ * graph with the same indices as the table, without recursion.
+ *
+ * Same as PersonTable_spreadMusic, but the neighbors are decoded from the
+ * compressed lists while they are visited.
+ *
+ * V: The graph's vertices number (program input "n")
+ * E: The graph's edges number (program input "m")
+ * Complexity: O(V+E).
+ *
+ * @param table The table holding the people.
+ * @param compact The compact graph holding the edges.
+ * @param person The index of the person who first listened the music.
+ * @param strategy SPREAD_BFS for breadth first, SPREAD_DFS for depth first.
+ * @return int How many people liked the music.
+ */
+int PersonTable_spreadMusicCompact(PersonTable *table, CompactGraph *compact,
+    int person, int strategy) {
+    unsigned long long *listened = table->listened;
+    int *frontier = table->frontier;
+    int *ages = table->ages;
+    int first = 0, size = 0, counter = 0, related;
+    CompactIterator iterator;
+
+    listened[person / 64] |= 1ULL << (person % 64);
+    frontier[size++] = person;
+    while (size > first) {
+        person = strategy == SPREAD_BFS ? frontier[first++] : frontier[--size];
+        if (ages[person] >= SPREAD_AGE_LIMIT) {
+            continue;
+        }
+        counter += 1;
+
+        CompactGraph_iterate(compact, person, &iterator);
+        while (CompactGraph_nextNeighbor(&iterator, &related)) {
+            unsigned long long bit = 1ULL << (related % 64);
+            if (!(listened[related / 64] & bit)) {
+                listened[related / 64] |= bit;
+                frontier[size++] = related;
+            }
+        }
+    }
+
+    return counter;
+}
+
+/**
+ * @brief Creates the parallel search used by PersonTable_spreadMusicParallel.
+ * The people younger than 35 are its eligible vertices.
+ *
+ * V: The table length.
+ * Complexity: O(V).
+ *
+ * @param table The table holding the people.
+ * @param csr The CSR graph holding the edges, with the same indices.
+ * @param threads The amount of threads used by each spread.
+ * @return ParallelBfs* The search, reused by all the spreads on the table.
+ */
+ParallelBfs * PersonTable_createParallelBfs(PersonTable *table,
+    CsrGraph *csr, int threads) {
+    return ParallelBfs_create(csr, PersonTable_createEligibleFlags(table),
+        threads);
+}
+
+/**
+ * @brief Spread the music hit given the first person's index on a CSR graph,
+ * using a multithreaded breadth first search.
+ *
+ * The listened bitset is used as the search visited bitmap, so it receives
+ * the people who liked the music. It must have been reset before.
+ *
+ * V: The graph's vertices number (program input "n")
+ * E: The graph's edges number (program input "m")
+ * Complexity: O(V+E) work, split among the threads.
+ *
+ * @param table The table holding the people.
+ * @param bfs The search created by PersonTable_createParallelBfs.
+ * @param person The index of the person who first listened the music.
+ * @return int How many people liked the music.
+ */
+int PersonTable_spreadMusicParallel(PersonTable *table, ParallelBfs *bfs,
+    int person) {
+    return ParallelBfs_search(bfs, person, table->listened, NULL, NULL);
+}
+
+/**
+ * @brief Spread the music hit from several first listeners on a CSR graph
+ * with the same indices as the table, propagating up to 64 of them on each
+ * traversal with MultiSpread_run. The listened marks are not used.
+ *
+ * V: The graph's vertices number (program input "n")
+ * E: The graph's edges number (program input "m")
+ * S: The amount of seeds.
+ * Complexity: O(S/64*(V+E)) for seeds on few components.
+ *
+ * @param table The table holding the people.
+ * @param csr The CSR graph holding the edges.
+ * @param seeds The index of each first listener. -1 for missing ones.
+ * @param length The amount of seeds.
+ * @param counts Receives how many people liked the music from each seed.
+ */
+void PersonTable_spreadMusicMulti(PersonTable *table, CsrGraph *csr,
+    const int *seeds, int length, int *counts) {
+    unsigned char *eligible = PersonTable_createEligibleFlags(table);
+    MultiSpread_run(csr, eligible, seeds, length, counts);
+    free(eligible);
+}
@@ -0,0 +1,55 @@
+#include <stdint.h>
+#include "csr_graph.h"
+#include "compact_graph.h"
+#include "parallel_bfs.h"
+
+#ifndef PERSON_TABLE_H
+#define PERSON_TABLE_H
+
+typedef struct person_table PersonTable;
+
+PersonTable * PersonTable_create(int capacity);
+
+PersonTable * PersonTable_createView(int length, int *ages,
+    int64_t *idOffsets, char *ids);
+
+void PersonTable_destroy(PersonTable *table);
+
+int PersonTable_getLength(PersonTable *table);
+
+int PersonTable_insert(PersonTable *table, char *id, int age);
+
+PersonTable * PersonTable_createPermuted(PersonTable *table,
+    const int *order);
+
+char * PersonTable_getId(PersonTable *table, int person);
+
+int PersonTable_getAge(PersonTable *table, int person);
+
+void PersonTable_sortById(PersonTable *table, int algorithm, int threads);
+
+int PersonTable_searchId(PersonTable *table, char *id);
+
+unsigned char * PersonTable_createEligibleFlags(PersonTable *table);
+
+void PersonTable_resetSpread(PersonTable *table);
+
+int PersonTable_spreadMusic(PersonTable *table, CsrGraph *csr, int person,
+    int strategy);
+
+int PersonTable_spreadMusicLevels(PersonTable *table, CsrGraph *csr,
+    int person, int maxHops, int *levels);
+
+int PersonTable_spreadMusicCompact(PersonTable *table, CompactGraph *compact,
+    int person, int strategy);
+
+ParallelBfs * PersonTable_createParallelBfs(PersonTable *table,
+    CsrGraph *csr, int threads);
+
+int PersonTable_spreadMusicParallel(PersonTable *table, ParallelBfs *bfs,
+    int person);
+
+void PersonTable_spreadMusicMulti(PersonTable *table, CsrGraph *csr,
+    const int *seeds, int length, int *counts);
+
+#endif
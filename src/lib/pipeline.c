@@ -0,0 +1,410 @@
+#include "pipeline.h"
+#include "graph.h"
+#include "csr_graph.h"
+#include "input.h"
+#include "person.h"
+#include "person_table.h"
+
+/**
+ * @brief Stores the people read by Pipeline_readPeople on the graph.
+ */
+struct pipeline_people {
+    /** The graph, created with "n" vertices. */
+    Graph *graph;
+    /** The arena the people and vertices are allocated on, or NULL. */
+    Arena *arena;
+};
+typedef struct pipeline_people PipelinePeople;
+
+/**
+ * @brief Stores the edges read by Pipeline_readEdges and
+ * Pipeline_readTableEdges on the structures given.
+ */
+struct pipeline_edges {
+    /** The graph holding the people, or NULL if they are on the table. */
+    Graph *graph;
+    /** The person table holding the people, or NULL. */
+    PersonTable *table;
+    /** The hash index, or NULL. */
+    PersonIndex *index;
+    /** The CSR graph, not built yet, or NULL. */
+    CsrGraph *csr;
+    /** The spread index, not built yet, or NULL. */
+    SpreadIndex *spreadIndex;
+    /** The age index, not built yet, or NULL. */
+    AgeIndex *ageIndex;
+};
+typedef struct pipeline_edges PipelineEdges;
+
+/**
+ * @brief Reads the people of the input, one "ID AGE" pair each, and gives
+ * them to the insertion function in the input order. The ids point to the
+ * input, so they are only valid during the call on a streamed input.
+ *
+ * n: The amount of people.
+ * Complexity: O(n) plus the insertions.
+ *
+ * @param input The input, placed after the header.
+ * @param n The amount of people.
+ * @param insert Called for each person.
+ * @param context Given to the insertion function.
+ * @return int The amount of people read. Less than "n" if the person after
+ * them is missing or malformed.
+ */
+int Pipeline_readPeopleWith(Input *input, int n, PipelinePerson insert,
+    void *context) {
+    for (int i = 0; i < n; i += 1) {
+        char *id = Input_nextToken(input, NULL);
+        int age = 0;
+        if (id == NULL || !Input_nextInt(input, &age)) {
+            return i;
+        }
+        insert(context, i, id, age);
+    }
+    return n;
+}
+
+/**
+ * @brief Creates the vertex of a person read by Pipeline_readPeople.
+ *
+ * @param context The PipelinePeople.
+ * @param position The person's position on the input.
+ * @param id The person's id.
+ * @param age The person's age.
+ */
+static void Pipeline_insertVertex(void *context, int position, char *id,
+    int age) {
+    PipelinePeople *people = (PipelinePeople *) context;
+    Arena *arena = people->arena;
+    Vertex *vertex = arena ?
+        Vertex_createInArena(arena, Person_createInArena(arena, id, age)) :
+        Vertex_create(Person_create(id, age));
+    Graph_insertVertex(people->graph, vertex, position);
+}
+
+/**
+ * @brief Reads the people of the input, one "ID AGE" pair each, and inserts
+ * them on the graph in the input order. The ids point to the input buffer, so
+ * the input must live as long as the people.
+ *
+ * n: The amount of people.
+ * Complexity: O(n).
+ *
+ * @param input The input, placed after the header.
+ * @param graph The graph, created with "n" vertices.
+ * @param arena The arena the people and vertices are allocated on, or NULL.
+ * @param n The amount of people.
+ * @return int The amount of people read. Less than "n" if the person after
+ * them is missing or malformed.
+ */
+int Pipeline_readPeople(Input *input, Graph *graph, Arena *arena, int n) {
+    PipelinePeople people;
+    people.graph = graph;
+    people.arena = arena;
+    return Pipeline_readPeopleWith(input, n, Pipeline_insertVertex, &people);
+}
+
+/**
+ * @brief Inserts a person read by Pipeline_readTablePeople on the table.
+ *
+ * @param context The person table.
+ * @param position The person's position on the input.
+ * @param id The person's id.
+ * @param age The person's age.
+ */
+static void Pipeline_insertTablePerson(void *context, int position, char *id,
+    int age) {
+    (void) position;
+    PersonTable_insert((PersonTable *) context, id, age);
+}
+
+/**
+ * @brief Reads the people of the input, one "ID AGE" pair each, and inserts
+ * them on the person table in the input order. The ids are copied into the
+ * table, so the people cost no allocation and outlive the input.
+ *
+ * n: The amount of people.
+ * Complexity: O(n) amortized.
+ *
+ * @param input The input, placed after the header.
+ * @param table The person table, created with capacity for "n" people.
+ * @param n The amount of people.
+ * @return int The amount of people read. Less than "n" if the person after
+ * them is missing or malformed.
+ */
+int Pipeline_readTablePeople(Input *input, PersonTable *table, int n) {
+    return Pipeline_readPeopleWith(input, n, Pipeline_insertTablePerson,
+        table);
+}
+
+/**
+ * @brief Prepares the people to be found by id: either builds a hash index,
+ * or sorts the vertices by id for the binary search.
+ *
+ * V: The graph's vertices number.
+ * Complexity: O(V) expected with the hash index, O(V*log(V)) otherwise.
+ *
+ * @param graph The graph holding the people.
+ * @param hash If 1, the hash index is built and the vertices keep their order.
+ * @param sort SORT_QUICKSORT or SORT_MULTIKEY, for the sort.
+ * @param threads Amount of threads of the multikey sort.
+ * @return PersonIndex* The hash index, or NULL if the vertices were sorted.
+ */
+PersonIndex * Pipeline_indexPeople(Graph *graph, int hash, int sort,
+    int threads) {
+    if (hash) {
+        return PersonIndex_create(graph);
+    }
+    if (sort == SORT_MULTIKEY) {
+        Graph_sortVerticesByPersonIdMultikey(graph, threads);
+    } else {
+        Graph_sortVerticesByPersonId(graph);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Search the vertex index of the given id, through the hash index if
+ * there is one, or the binary search over the sorted vertices otherwise.
+ *
+ * V: The graph's vertices number.
+ * Complexity: O(1) expected with the hash index, O(log(V)) otherwise.
+ *
+ * @param graph The graph.
+ * @param index The hash index, or NULL.
+ * @param id The person's id.
+ * @return int The person's vertex index. -1 if not found.
+ */
+int Pipeline_searchPerson(Graph *graph, PersonIndex *index, char *id) {
+    if (index) {
+        return PersonIndex_search(index, id);
+    }
+    return Graph_searchPersonIndexById(graph, id);
+}
+
+/**
+ * @brief Search the table index of the given id, through the hash index if
+ * there is one, or the binary search over the sorted table otherwise.
+ *
+ * V: The table's people number.
+ * Complexity: O(1) expected with the hash index, O(log(V)) otherwise.
+ *
+ * @param table The person table.
+ * @param index The hash index, or NULL.
+ * @param id The person's id.
+ * @return int The person's table index. -1 if not found.
+ */
+int Pipeline_searchTablePerson(PersonTable *table, PersonIndex *index,
+    char *id) {
+    if (index) {
+        return PersonIndex_search(index, id);
+    }
+    return PersonTable_searchId(table, id);
+}
+
+/**
+ * @brief Reads the edges of the input, one "ID1 ID2" pair each, and gives them
+ * to the insertion function. The reading stops on the end of the input.
+ *
+ * m: The amount of edges.
+ * Complexity: O(m) plus the insertions.
+ *
+ * @param input The input, placed after the people.
+ * @param m The amount of edges.
+ * @param insert Called for each edge.
+ * @param context Given to the insertion function.
+ * @return int 1 on success, 0 if an insertion failed.
+ */
+int Pipeline_readEdgesWith(Input *input, int m, PipelineEdge insert,
+    void *context) {
+    for (int i = 0; i < m; i += 1) {
+        char *id1 = Input_nextToken(input, NULL);
+        char *id2 = Input_nextToken(input, NULL);
+        if (id1 == NULL || id2 == NULL) {
+            break;
+        }
+        if (!insert(context, id1, id2)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Stores an edge read by Pipeline_readEdges on the first structure
+ * given. Edges with an unknown id are skipped.
+ *
+ * @param context The PipelineEdges.
+ * @param id1 The first person's id.
+ * @param id2 The second person's id.
+ * @return int 1 on success, 0 if the age index could not be allocated.
+ */
+static int Pipeline_insertEdge(void *context, char *id1, char *id2) {
+    PipelineEdges *edges = (PipelineEdges *) context;
+    int index1 = Pipeline_searchPerson(edges->graph, edges->index, id1);
+    int index2 = Pipeline_searchPerson(edges->graph, edges->index, id2);
+    if (index1 < 0 || index2 < 0) {
+        return 1;
+    }
+
+    if (edges->ageIndex) {
+        return AgeIndex_insertEdge(edges->ageIndex, index1, index2);
+    } else if (edges->spreadIndex) {
+        SpreadIndex_insertEdge(edges->spreadIndex, index1, index2);
+    } else if (edges->csr) {
+        CsrGraph_insertEdge(edges->csr, index1, index2, 0);
+    } else {
+        Vertex **vertices = Graph_getVertices(edges->graph);
+        Vertex_setEdge(vertices[index1], vertices[index2], 0);
+    }
+    return 1;
+}
+
+/**
+ * @brief Reads the edges of the input, one "ID1 ID2" pair each, and stores
+ * them on the first structure given: the age index, the spread index, the
+ * CSR graph, or else the vertices lists. The given indices and graph are built
+ * afterwards. Edges with an unknown id are skipped, and the reading stops on
+ * the end of the input.
+ *
+ * V: The graph's vertices number.
+ * E: The amount of edges.
+ * Complexity: O(V+E*log(V)), or O(V+E) expected with the hash index.
+ *
+ * @param input The input, placed after the people.
+ * @param m The amount of edges.
+ * @param graph The graph holding the people.
+ * @param index The hash index, or NULL.
+ * @param csr The CSR graph, not built yet, or NULL.
+ * @param spreadIndex The spread index, not built yet, or NULL.
+ * @param ageIndex The age index, not built yet, or NULL.
+ * @return int 1 on success, 0 if the age index could not be allocated.
+ */
+int Pipeline_readEdges(Input *input, int m, Graph *graph, PersonIndex *index,
+    CsrGraph *csr, SpreadIndex *spreadIndex, AgeIndex *ageIndex) {
+    PipelineEdges edges;
+    edges.graph = graph;
+    edges.table = NULL;
+    edges.index = index;
+    edges.csr = csr;
+    edges.spreadIndex = spreadIndex;
+    edges.ageIndex = ageIndex;
+    if (!Pipeline_readEdgesWith(input, m, Pipeline_insertEdge, &edges)) {
+        return 0;
+    }
+
+    if (csr) {
+        CsrGraph_build(csr);
+    }
+    if (spreadIndex) {
+        SpreadIndex_build(spreadIndex);
+    }
+    if (ageIndex) {
+        return AgeIndex_build(ageIndex);
+    }
+    return 1;
+}
+
+/**
+ * @brief Stores an edge read by Pipeline_readTableEdges on every structure
+ * given. Edges with an unknown id are skipped.
+ *
+ * @param context The PipelineEdges.
+ * @param id1 The first person's id.
+ * @param id2 The second person's id.
+ * @return int Always 1.
+ */
+static int Pipeline_insertTableEdge(void *context, char *id1, char *id2) {
+    PipelineEdges *edges = (PipelineEdges *) context;
+    int index1 = Pipeline_searchTablePerson(edges->table, edges->index, id1);
+    int index2 = Pipeline_searchTablePerson(edges->table, edges->index, id2);
+    if (index1 < 0 || index2 < 0) {
+        return 1;
+    }
+
+    if (edges->spreadIndex) {
+        SpreadIndex_insertEdge(edges->spreadIndex, index1, index2);
+    }
+    if (edges->csr) {
+        CsrGraph_insertEdge(edges->csr, index1, index2, 0);
+    }
+    return 1;
+}
+
+/**
+ * @brief Reads the edges of the input, one "ID1 ID2" pair each, and stores
+ * them on the spread index and on the CSR graph of the person table, which
+ * are built afterwards. Edges with an unknown id are skipped, and the reading
+ * stops on the end of the input.
+ *
+ * V: The table's people number.
+ * E: The amount of edges.
+ * Complexity: O(V+E*log(V)), or O(V+E) expected with the hash index.
+ *
+ * @param input The input, placed after the people.
+ * @param m The amount of edges.
+ * @param table The person table.
+ * @param index The hash index, or NULL.
+ * @param csr The CSR graph, not built yet, or NULL.
+ * @param spreadIndex The spread index, not built yet, or NULL.
+ */
+void Pipeline_readTableEdges(Input *input, int m, PersonTable *table,
+    PersonIndex *index, CsrGraph *csr, SpreadIndex *spreadIndex) {
+    PipelineEdges edges;
+    edges.graph = NULL;
+    edges.table = table;
+    edges.index = index;
+    edges.csr = csr;
+    edges.spreadIndex = spreadIndex;
+    edges.ageIndex = NULL;
+    Pipeline_readEdgesWith(input, m, Pipeline_insertTableEdge, &edges);
+
+    if (csr) {
+        CsrGraph_build(csr);
+    }
+    if (spreadIndex) {
+        SpreadIndex_build(spreadIndex);
+    }
+}
+
+/**
+ * @brief Spreads the music from the given person with the traversal over the
+ * most specific edges structure given: the parallel search, the compact
+ * graph, the CSR graph, or else the vertices lists.
+ *
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * Complexity: O(V+E).
+ *
+ * @param graph The graph holding the people.
+ * @param csr The CSR graph, or NULL if the edges are on the vertices lists.
+ * @param compact The compact graph, or NULL. It replaces the CSR graph.
+ * @param bfs The parallel search over the CSR graph, or NULL.
+ * @param vertex The vertex index of the person who first listened.
+ * @param recursive If 1, the recursive traversal is used. The compact graph
+ * has no recursive traversal, so it uses SPREAD_DFS instead.
+ * @param strategy SPREAD_DFS or SPREAD_BFS, for the iterative traversals.
+ * @return int How many people liked the music.
+ */
+int Pipeline_spreadMusic(Graph *graph, CsrGraph *csr, CompactGraph *compact,
+    ParallelBfs *bfs, int vertex, int recursive, int strategy) {
+    int counter = 0;
+    Vertex *start = Graph_getVertices(graph)[vertex];
+
+    if (bfs) {
+        Person_spreadMusicParallel(graph, csr, bfs, vertex, &counter);
+    } else if (compact) {
+        Person_spreadMusicCompact(graph, compact, vertex, &counter,
+            recursive ? SPREAD_DFS : strategy);
+    } else if (csr && recursive) {
+        Person_spreadMusicCsr(graph, csr, vertex, &counter);
+    } else if (csr) {
+        Person_spreadMusicCsrIterative(graph, csr, vertex, &counter, strategy);
+    } else if (recursive) {
+        Person_spreadMusic(start, &counter);
+    } else {
+        Person_spreadMusicIterative(start, &counter, strategy);
+    }
+
+    return counter;
+}
@@ -0,0 +1,55 @@
+#include "graph.h"
+#include "csr_graph.h"
+#include "compact_graph.h"
+#include "parallel_bfs.h"
+#include "arena.h"
+#include "input.h"
+#include "person.h"
+#include "spread_index.h"
+#include "age_index.h"
+#include "person_table.h"
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+/**
+ * @brief Stores a person read from the input. Receives the context given to
+ * the reader, the person's position on the input, id and age.
+ */
+typedef void (*PipelinePerson)(void *context, int position, char *id,
+    int age);
+
+/**
+ * @brief Stores an edge read from the input. Receives the context given to
+ * the reader and the ids of both people. Returns 0 to stop the reading.
+ */
+typedef int (*PipelineEdge)(void *context, char *id1, char *id2);
+
+int Pipeline_readPeopleWith(Input *input, int n, PipelinePerson insert,
+    void *context);
+
+int Pipeline_readPeople(Input *input, Graph *graph, Arena *arena, int n);
+
+int Pipeline_readTablePeople(Input *input, PersonTable *table, int n);
+
+PersonIndex * Pipeline_indexPeople(Graph *graph, int hash, int sort,
+    int threads);
+
+int Pipeline_searchPerson(Graph *graph, PersonIndex *index, char *id);
+
+int Pipeline_searchTablePerson(PersonTable *table, PersonIndex *index,
+    char *id);
+
+int Pipeline_readEdgesWith(Input *input, int m, PipelineEdge insert,
+    void *context);
+
+int Pipeline_readEdges(Input *input, int m, Graph *graph, PersonIndex *index,
+    CsrGraph *csr, SpreadIndex *spreadIndex, AgeIndex *ageIndex);
+
+void Pipeline_readTableEdges(Input *input, int m, PersonTable *table,
+    PersonIndex *index, CsrGraph *csr, SpreadIndex *spreadIndex);
+
+int Pipeline_spreadMusic(Graph *graph, CsrGraph *csr, CompactGraph *compact,
+    ParallelBfs *bfs, int vertex, int recursive, int strategy);
+
+#endif
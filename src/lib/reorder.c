@@ -0,0 +1,261 @@
+#include <stdlib.h>
+#include <string.h>
+#include "reorder.h"
+#include "csr_graph.h"
+
+/**
+ * @brief Neighbor lists shorter than this are sorted by insertion.
+ */
+#define REORDER_INSERTION_LENGTH 16
+
+/**
+ * @brief Sorts the vertices by their keys with a counting sort, so the
+ * vertices with the same key keep their relative order.
+ *
+ * n: The amount of vertices.
+ * K: The largest key.
+ * Complexity: O(n+K).
+ *
+ * @param vertices The vertices to be sorted.
+ * @param length The amount of vertices.
+ * @param keys The key of each vertex, indexed by the vertex.
+ * @param maxKey The largest key.
+ * @param descending If 1, the larger keys come first.
+ */
+static void Reorder_sortByKey(int *vertices, int length, const int *keys,
+    int maxKey, int descending) {
+    int *starts = (int *) calloc(maxKey + 2, sizeof(int));
+    int *sorted = (int *) malloc((length + 1) * sizeof(int));
+    int i;
+
+    for (i = 0; i < length; i += 1) {
+        int key = descending ? maxKey - keys[vertices[i]] : keys[vertices[i]];
+        starts[key + 1] += 1;
+    }
+    for (i = 0; i <= maxKey; i += 1) {
+        starts[i + 1] += starts[i];
+    }
+    for (i = 0; i < length; i += 1) {
+        int key = descending ? maxKey - keys[vertices[i]] : keys[vertices[i]];
+        sorted[starts[key]++] = vertices[i];
+    }
+
+    memcpy(vertices, sorted, length * sizeof(int));
+    free(starts);
+    free(sorted);
+}
+
+/**
+ * @brief Sorts a short run of vertices by their keys, by insertion.
+ *
+ * n: The run length.
+ * Complexity: O(n^2).
+ */
+static void Reorder_insertionByKey(int *vertices, int length,
+    const int *keys) {
+    for (int i = 1; i < length; i += 1) {
+        int vertex = vertices[i];
+        int j = i - 1;
+        while (j >= 0 && keys[vertices[j]] > keys[vertex]) {
+            vertices[j + 1] = vertices[j];
+            j -= 1;
+        }
+        vertices[j + 1] = vertex;
+    }
+}
+
+/**
+ * @brief Keys used by the neighbor lists sort comparison.
+ */
+static const int *reorder_sorting_keys;
+
+/**
+ * @brief Compares two vertices by their keys.
+ */
+static int Reorder_compareKeys(const void *a, const void *b) {
+    int key1 = reorder_sorting_keys[*(const int *) a];
+    int key2 = reorder_sorting_keys[*(const int *) b];
+    return (key1 > key2) - (key1 < key2);
+}
+
+/**
+ * @brief Sorts a run of vertices by their keys.
+ *
+ * n: The run length.
+ * Complexity: O(n*log(n)).
+ */
+static void Reorder_sortRun(int *vertices, int length, const int *keys) {
+    if (length <= REORDER_INSERTION_LENGTH) {
+        Reorder_insertionByKey(vertices, length, keys);
+        return;
+    }
+    reorder_sorting_keys = keys;
+    qsort(vertices, length, sizeof(int), Reorder_compareKeys);
+}
+
+/**
+ * @brief Compares two vertices indices.
+ */
+static int Reorder_compareVertices(const void *a, const void *b) {
+    int vertex1 = *(const int *) a, vertex2 = *(const int *) b;
+    return (vertex1 > vertex2) - (vertex1 < vertex2);
+}
+
+/**
+ * @brief Sorts a neighbor list by increasing index.
+ *
+ * n: The list length.
+ * Complexity: O(n*log(n)).
+ */
+static void Reorder_sortNeighbors(int *neighbors, int length) {
+    if (length > REORDER_INSERTION_LENGTH) {
+        qsort(neighbors, length, sizeof(int), Reorder_compareVertices);
+        return;
+    }
+    for (int i = 1; i < length; i += 1) {
+        int vertex = neighbors[i];
+        int j = i - 1;
+        while (j >= 0 && neighbors[j] > vertex) {
+            neighbors[j + 1] = neighbors[j];
+            j -= 1;
+        }
+        neighbors[j + 1] = vertex;
+    }
+}
+
+/**
+ * @brief Computes the reverse Cuthill-McKee order: a breadth first search
+ * from each component's vertex of least degree, queueing the neighbors by
+ * increasing degree, reversed at the end. Vertices close on the graph get
+ * close indices, so the neighbors of a vertex are near each other on the
+ * people arrays.
+ *
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * Complexity: O(V+E*log(E/V)).
+ *
+ * @param graph The CSR graph.
+ * @param degrees The degree of each vertex.
+ * @param maxDegree The largest degree.
+ * @param order Receives the old index of each new position.
+ */
+static void Reorder_computeRcm(CsrGraph *graph, const int *degrees,
+    int maxDegree, int *order) {
+    int length = CsrGraph_getVerticesNumber(graph);
+    int *starts = (int *) malloc((length + 1) * sizeof(int));
+    unsigned char *visited = (unsigned char *) calloc(length + 1, 1);
+    int size = 0, first = 0, i;
+
+    for (i = 0; i < length; i += 1) {
+        starts[i] = i;
+    }
+    Reorder_sortByKey(starts, length, degrees, maxDegree, 0);
+
+    for (i = 0; i < length; i += 1) {
+        if (visited[starts[i]]) {
+            continue;
+        }
+        visited[starts[i]] = 1;
+        order[size++] = starts[i];
+
+        while (first < size) {
+            int vertex = order[first++];
+            int degree = CsrGraph_getDegree(graph, vertex);
+            int *neighbors = CsrGraph_getNeighbors(graph, vertex);
+            int queued = size;
+            for (int j = 0; j < degree; j += 1) {
+                if (!visited[neighbors[j]]) {
+                    visited[neighbors[j]] = 1;
+                    order[size++] = neighbors[j];
+                }
+            }
+            Reorder_sortRun(order + queued, size - queued, degrees);
+        }
+    }
+
+    for (i = 0; i < length / 2; i += 1) {
+        int vertex = order[i];
+        order[i] = order[length - 1 - i];
+        order[length - 1 - i] = vertex;
+    }
+
+    free(starts);
+    free(visited);
+}
+
+/**
+ * @brief Computes a new order of the vertices of the graph, meant to place
+ * the vertices visited together by a traversal close on memory.
+ *
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * Complexity: O(V+E*log(E/V)) for REORDER_RCM, O(V+E) otherwise.
+ *
+ * @param graph The built CSR graph.
+ * @param strategy REORDER_RCM for the reverse Cuthill-McKee order,
+ * REORDER_DEGREE to place the vertices by decreasing degree, so the hubs
+ * share the same cache lines, or REORDER_NONE to keep the order.
+ * @param order Receives the old index of each new position.
+ */
+void Reorder_compute(CsrGraph *graph, int strategy, int *order) {
+    int length = CsrGraph_getVerticesNumber(graph);
+    int *degrees = (int *) malloc((length + 1) * sizeof(int));
+    int maxDegree = 0, i;
+
+    for (i = 0; i < length; i += 1) {
+        degrees[i] = CsrGraph_getDegree(graph, i);
+        if (degrees[i] > maxDegree) {
+            maxDegree = degrees[i];
+        }
+        order[i] = i;
+    }
+
+    if (strategy == REORDER_RCM) {
+        Reorder_computeRcm(graph, degrees, maxDegree, order);
+    } else if (strategy == REORDER_DEGREE) {
+        Reorder_sortByKey(order, length, degrees, maxDegree, 1);
+    }
+
+    free(degrees);
+}
+
+/**
+ * @brief Creates a copy of the graph with the vertices relabeled, so the old
+ * vertex order[i] becomes the vertex i. Each neighbor list is sorted, so the
+ * traversals read the people arrays forward.
+ *
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * Complexity: O(V+E*log(E/V)).
+ *
+ * @param graph The built CSR graph.
+ * @param order The old index of each new position.
+ * @return CsrGraph* The relabeled graph.
+ */
+CsrGraph * Reorder_permuteGraph(CsrGraph *graph, const int *order) {
+    int length = CsrGraph_getVerticesNumber(graph);
+    int *labels = (int *) malloc((length + 1) * sizeof(int));
+    int *offsets = (int *) malloc((length + 1) * sizeof(int));
+    int *neighbors = (int *) malloc(
+        ((size_t) CsrGraph_getNeighborsNumber(graph) + 1) * sizeof(int));
+    int i;
+
+    for (i = 0; i < length; i += 1) {
+        labels[order[i]] = i;
+    }
+
+    offsets[0] = 0;
+    for (i = 0; i < length; i += 1) {
+        int degree = CsrGraph_getDegree(graph, order[i]);
+        int *oldNeighbors = CsrGraph_getNeighbors(graph, order[i]);
+        int *newNeighbors = neighbors + offsets[i];
+        for (int j = 0; j < degree; j += 1) {
+            newNeighbors[j] = labels[oldNeighbors[j]];
+        }
+        Reorder_sortNeighbors(newNeighbors, degree);
+        offsets[i + 1] = offsets[i] + degree;
+    }
+
+    free(labels);
+    return CsrGraph_createFromArrays(length, offsets, neighbors);
+}
@@ -0,0 +1,15 @@
+#include "csr_graph.h"
+
+#ifndef REORDER_H
+#define REORDER_H
+
+/** Vertex orderings. */
+#define REORDER_NONE 0
+#define REORDER_RCM 1
+#define REORDER_DEGREE 2
+
+void Reorder_compute(CsrGraph *graph, int strategy, int *order);
+
+CsrGraph * Reorder_permuteGraph(CsrGraph *graph, const int *order);
+
+#endif
@@ -0,0 +1,500 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "server.h"
+
+/**
+ * @brief Length of the replies buffer of each connection.
+ */
+#define SERVER_OUTPUT_CAPACITY (1 << 16)
+
+/**
+ * @brief Longest reply line: a count and a latency.
+ */
+#define SERVER_REPLY_LENGTH 64
+
+/**
+ * @brief Connection being served.
+ */
+struct server_client {
+    /** The connection socket, non blocking. */
+    int descriptor;
+    /** Bytes received and not answered yet. */
+    char line[SERVER_LINE_CAPACITY];
+    /** Amount of bytes on the line buffer. */
+    int length;
+    /** If 1, the bytes until the next newline belong to a line too long and
+     * are discarded. */
+    int discarding;
+    /** If 1, the client will send no more bytes. */
+    int ended;
+    /** Replies not written on the socket yet. */
+    char output[SERVER_OUTPUT_CAPACITY];
+    /** Amount of bytes on the output buffer. */
+    int outputLength;
+};
+typedef struct server_client ServerClient;
+
+/**
+ * @brief Server structure.
+ *
+ * Listens on a Unix domain socket and answers line requests, one reply line
+ * per request, in order. The connections are multiplexed with poll on a
+ * single thread, so the queries never run concurrently. The sockets are non
+ * blocking and each connection buffers its replies: a client may pipeline as
+ * many requests as it wants, and a client that stops reading only stops
+ * being read once its output buffer is full, without stalling the others.
+ */
+struct server {
+    /** The listening socket. */
+    int descriptor;
+    /** Path of the socket file, removed with the server. */
+    char *path;
+    /** The connections being served. */
+    ServerClient *clients;
+    /** Amount of connections being served. */
+    int clientsNumber;
+    /** Amount of requests answered. */
+    long long queries;
+    /** Sum of the requests latencies, in microseconds. */
+    double latencySum;
+    /** Largest request latency, in microseconds. */
+    double latencyMax;
+};
+
+/**
+ * @brief Set by the SIGINT and SIGTERM handler to stop Server_run.
+ */
+static volatile sig_atomic_t server_stopped = 0;
+
+/**
+ * @brief Pipe written by the signal handler and polled by Server_run, so a
+ * signal received right before the poll, or by another thread, still wakes
+ * it up.
+ */
+static int server_wakeup[2] = { -1, -1 };
+
+/**
+ * @brief Stops the server loop.
+ */
+static void Server_stop(int signal) {
+    int error = errno;
+    (void) signal;
+    server_stopped = 1;
+    // A full pipe fails the write, but then the loop is already awake.
+    if (server_wakeup[1] >= 0) {
+        ssize_t written = write(server_wakeup[1], "", 1);
+        (void) written;
+    }
+    errno = error;
+}
+
+/**
+ * @brief Creates a server listening on the given socket path. A stale socket
+ * left on the path is replaced, but no other kind of file.
+ *
+ * Complexity: O(1).
+ *
+ * @param path Path of the socket file.
+ * @return Server* A pointer to the created server, or NULL if the socket
+ * could not be created.
+ */
+Server * Server_create(const char *path) {
+    struct sockaddr_un address;
+    struct stat status;
+
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        return NULL;
+    }
+    if (lstat(path, &status) == 0 && S_ISSOCK(status.st_mode)) {
+        unlink(path);
+    }
+
+    int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (descriptor < 0) {
+        return NULL;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    if (bind(descriptor, (struct sockaddr *) &address, sizeof(address)) < 0 ||
+        listen(descriptor, SOMAXCONN) < 0) {
+        close(descriptor);
+        return NULL;
+    }
+
+    Server *server = (Server *) malloc(sizeof(Server));
+    server->descriptor = descriptor;
+    server->path = strdup(path);
+    server->clients = (ServerClient *) malloc(SERVER_MAX_CLIENTS *
+        sizeof(ServerClient));
+    server->clientsNumber = 0;
+    server->queries = 0;
+    server->latencySum = 0;
+    server->latencyMax = 0;
+    return server;
+}
+
+/**
+ * @brief Destroys the given server, closing its connections and removing its
+ * socket file.
+ *
+ * Complexity: O(1).
+ *
+ * @param server The server to be destroyed.
+ */
+void Server_destroy(Server *server) {
+    for (int i = 0; i < server->clientsNumber; i += 1) {
+        close(server->clients[i].descriptor);
+    }
+    close(server->descriptor);
+    unlink(server->path);
+    free(server->path);
+    free(server->clients);
+    free(server);
+}
+
+/**
+ * @brief Writes as much of the connection output buffer as the socket takes
+ * without blocking. The bytes not written are moved to the buffer front.
+ *
+ * @param client The connection.
+ * @return int 1 on success, 0 if the connection failed.
+ */
+static int Server_flush(ServerClient *client) {
+    int written = 0;
+
+    while (written < client->outputLength) {
+        ssize_t sent = send(client->descriptor, client->output + written,
+            client->outputLength - written, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (sent <= 0) {
+            return 0;
+        }
+        written += sent;
+    }
+
+    client->outputLength -= written;
+    memmove(client->output, client->output + written, client->outputLength);
+    return 1;
+}
+
+/**
+ * @brief Getter for the time elapsed since an arbitrary point, in
+ * microseconds.
+ */
+static double Server_now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+}
+
+/**
+ * @brief Answers a request line, appending its reply to the output: the
+ * query result and its latency in microseconds. Blank lines get no reply.
+ *
+ * @param server The server.
+ * @param line The line, without the newline. It is changed.
+ * @param query The query function.
+ * @param context The query context.
+ * @param output The output buffer, with SERVER_REPLY_LENGTH free bytes.
+ * @return int The amount of bytes appended.
+ */
+static int Server_answer(Server *server, char *line, ServerQuery query,
+    void *context, char *output) {
+    char *end = line + strlen(line);
+    while (line < end && (*line == ' ' || *line == '\t')) {
+        line += 1;
+    }
+    while (end > line && (end[-1] == ' ' || end[-1] == '\t' ||
+        end[-1] == '\r')) {
+        end -= 1;
+    }
+    if (end == line) {
+        return 0;
+    }
+    *end = '\0';
+
+    double start = Server_now();
+    int result = query(context, line);
+    double latency = Server_now() - start;
+
+    server->queries += 1;
+    server->latencySum += latency;
+    if (latency > server->latencyMax) {
+        server->latencyMax = latency;
+    }
+    return snprintf(output, SERVER_REPLY_LENGTH, "%d %.1f\n", result,
+        latency);
+}
+
+/**
+ * @brief Answers the complete lines received on a connection, while its
+ * output buffer has room for their replies. The lines left wait for the
+ * output to be written.
+ *
+ * n: The amount of bytes on the line buffer.
+ * Complexity: O(n) plus the queries.
+ *
+ * @param server The server.
+ * @param client The connection.
+ * @param query The query function.
+ * @param context The query context.
+ */
+static void Server_answerLines(Server *server, ServerClient *client,
+    ServerQuery query, void *context) {
+    int first = 0;
+
+    while (client->outputLength <=
+        SERVER_OUTPUT_CAPACITY - SERVER_REPLY_LENGTH) {
+        char *newline = (char *) memchr(client->line + first, '\n',
+            client->length - first);
+
+        if (newline == NULL) {
+            // A full buffer without a newline is a line too long: it is
+            // refused and discarded until its newline arrives.
+            if (first == 0 && client->length == SERVER_LINE_CAPACITY) {
+                if (!client->discarding) {
+                    client->outputLength += snprintf(client->output +
+                        client->outputLength, SERVER_REPLY_LENGTH,
+                        "ERROR line too long\n");
+                }
+                client->discarding = 1;
+                client->length = 0;
+            }
+            break;
+        }
+
+        *newline = '\0';
+        if (client->discarding) {
+            client->discarding = 0;
+        } else {
+            client->outputLength += Server_answer(server, client->line + first,
+                query, context, client->output + client->outputLength);
+        }
+        first = newline - client->line + 1;
+    }
+
+    client->length -= first;
+    memmove(client->line, client->line + first, client->length);
+}
+
+/**
+ * @brief Checks if a connection has a complete line waiting for an answer.
+ *
+ * @param client The connection.
+ * @return int 1 if it has, 0 otherwise.
+ */
+static int Server_hasLine(ServerClient *client) {
+    return memchr(client->line, '\n', client->length) != NULL ||
+        client->length == SERVER_LINE_CAPACITY;
+}
+
+/**
+ * @brief Serves a connection the poll found ready: reads the bytes available,
+ * answers the lines while there is room for the replies and writes them as
+ * far as the socket takes.
+ *
+ * n: The amount of bytes read.
+ * Complexity: O(n) plus the queries.
+ *
+ * @param server The server.
+ * @param client The connection.
+ * @param events The events found by the poll.
+ * @param query The query function.
+ * @param context The query context.
+ * @return int 1 if the connection is still open, 0 if it must be closed.
+ */
+static int Server_serveClient(Server *server, ServerClient *client,
+    short events, ServerQuery query, void *context) {
+    if ((events & (POLLIN | POLLHUP | POLLERR)) && !client->ended &&
+        client->length < SERVER_LINE_CAPACITY) {
+        ssize_t received = read(client->descriptor,
+            client->line + client->length,
+            SERVER_LINE_CAPACITY - client->length);
+        if (received == 0) {
+            // A last line without a newline is answered too.
+            client->ended = 1;
+            if (client->length > 0 &&
+                client->line[client->length - 1] != '\n') {
+                client->line[client->length++] = '\n';
+            }
+        } else if (received > 0) {
+            client->length += received;
+        } else if (errno != EINTR && errno != EAGAIN &&
+            errno != EWOULDBLOCK) {
+            return 0;
+        }
+    }
+
+    // The replies written free room for the lines still waiting. It stops
+    // when no line is left, or when the socket takes no more replies.
+    while (1) {
+        Server_answerLines(server, client, query, context);
+        if (!Server_flush(client)) {
+            return 0;
+        }
+        if (!Server_hasLine(client) || client->outputLength >
+            SERVER_OUTPUT_CAPACITY - SERVER_REPLY_LENGTH) {
+            break;
+        }
+    }
+
+    return !client->ended || client->outputLength > 0 ||
+        Server_hasLine(client);
+}
+
+/**
+ * @brief Accepts a new connection. If SERVER_MAX_CLIENTS connections are
+ * already being served, the new one is refused.
+ *
+ * @param server The server.
+ */
+static void Server_accept(Server *server) {
+    int descriptor = accept(server->descriptor, NULL, NULL);
+    if (descriptor < 0) {
+        return;
+    }
+    if (server->clientsNumber == SERVER_MAX_CLIENTS) {
+        send(descriptor, "ERROR busy\n", 11, MSG_NOSIGNAL | MSG_DONTWAIT);
+        close(descriptor);
+        return;
+    }
+
+    fcntl(descriptor, F_SETFL, fcntl(descriptor, F_GETFL) | O_NONBLOCK);
+    ServerClient *client = &server->clients[server->clientsNumber++];
+    client->descriptor = descriptor;
+    client->length = 0;
+    client->discarding = 0;
+    client->ended = 0;
+    client->outputLength = 0;
+}
+
+/**
+ * @brief Serves the connections until a SIGINT or SIGTERM is received. Each
+ * request line is given to the query function, and its result is replied as
+ * a "RESULT LATENCY" line, the latency being the query time in microseconds.
+ *
+ * @param server The server.
+ * @param query The query function.
+ * @param context The query context.
+ * @return int 1 when stopped by a signal, 0 if the listening socket failed.
+ */
+int Server_run(Server *server, ServerQuery query, void *context) {
+    struct pollfd polls[SERVER_MAX_CLIENTS + 2];
+    struct sigaction action, oldInterrupt, oldTerminate;
+    int status = 1, i;
+
+    if (pipe(server_wakeup) < 0) {
+        return 0;
+    }
+    for (i = 0; i < 2; i += 1) {
+        fcntl(server_wakeup[i], F_SETFL,
+            fcntl(server_wakeup[i], F_GETFL) | O_NONBLOCK);
+    }
+
+    // No SA_RESTART, so the signals interrupt poll.
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = Server_stop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, &oldInterrupt);
+    sigaction(SIGTERM, &action, &oldTerminate);
+    server_stopped = 0;
+
+    while (!server_stopped) {
+        int length = server->clientsNumber;
+        polls[0].fd = server->descriptor;
+        polls[0].events = POLLIN;
+        polls[1].fd = server_wakeup[0];
+        polls[1].events = POLLIN;
+        // A connection is read only while its lines can be answered, and
+        // polled for writing only while it has replies waiting.
+        for (i = 0; i < length; i += 1) {
+            ServerClient *client = &server->clients[i];
+            polls[i + 2].fd = client->descriptor;
+            polls[i + 2].events = 0;
+            if (!client->ended && !Server_hasLine(client)) {
+                polls[i + 2].events |= POLLIN;
+            }
+            if (client->outputLength > 0) {
+                polls[i + 2].events |= POLLOUT;
+            }
+        }
+
+        if (poll(polls, length + 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            status = 0;
+            break;
+        }
+
+        // Backwards, so a closed connection is replaced by one already served.
+        for (i = length - 1; i >= 0; i -= 1) {
+            if (!polls[i + 2].revents) {
+                continue;
+            }
+            ServerClient *client = &server->clients[i];
+            if (!Server_serveClient(server, client, polls[i + 2].revents,
+                query, context)) {
+                close(client->descriptor);
+                *client = server->clients[--server->clientsNumber];
+            }
+        }
+        if (polls[0].revents & POLLIN) {
+            Server_accept(server);
+        }
+    }
+
+    sigaction(SIGINT, &oldInterrupt, NULL);
+    sigaction(SIGTERM, &oldTerminate, NULL);
+    for (i = 0; i < 2; i += 1) {
+        close(server_wakeup[i]);
+        server_wakeup[i] = -1;
+    }
+    return status;
+}
+
+/**
+ * @brief Getter for the amount of requests answered.
+ *
+ * @param server The server.
+ * @return long long The amount of requests.
+ */
+long long Server_getQueries(Server *server) {
+    return server->queries;
+}
+
+/**
+ * @brief Getter for the sum of the requests latencies.
+ *
+ * @param server The server.
+ * @return double The sum, in microseconds.
+ */
+double Server_getLatencySum(Server *server) {
+    return server->latencySum;
+}
+
+/**
+ * @brief Getter for the largest request latency.
+ *
+ * @param server The server.
+ * @return double The latency, in microseconds.
+ */
+double Server_getLatencyMax(Server *server) {
+    return server->latencyMax;
+}
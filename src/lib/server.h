@@ -0,0 +1,30 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+/** Maximum amount of connections served at the same time. */
+#define SERVER_MAX_CLIENTS 64
+
+/** Maximum length of a request line, newline included. */
+#define SERVER_LINE_CAPACITY 4096
+
+typedef struct server Server;
+
+/**
+ * @brief Answers a request line. Receives the context given to Server_run and
+ * the line, without the newline and the surrounding spaces.
+ */
+typedef int (*ServerQuery)(void *context, char *line);
+
+Server * Server_create(const char *path);
+
+void Server_destroy(Server *server);
+
+int Server_run(Server *server, ServerQuery query, void *context);
+
+long long Server_getQueries(Server *server);
+
+double Server_getLatencySum(Server *server);
+
+double Server_getLatencyMax(Server *server);
+
+#endif
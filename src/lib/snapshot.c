@@ -0,0 +1,415 @@
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "snapshot.h"
+#include "csr_graph.h"
+#include "person.h"
+#include "person_table.h"
+
+/**
+ * @brief Magic bytes on the start of every snapshot file.
+ */
+#define SNAPSHOT_MAGIC "TP0SNAP"
+
+/**
+ * @brief Snapshot file header.
+ *
+ * The header is followed by these sections, each one starting on a multiple
+ * of 8 bytes:
+ * - int64 idOffsets[verticesNumber + 1]: start of each id on the ids section;
+ * - int32 ages[verticesNumber];
+ * - int32 offsets[verticesNumber + 1]: the CSR offsets;
+ * - int32 neighbors[neighborsNumber]: the CSR neighbors;
+ * - char ids[idsLength]: the ids, each one terminated by '\0'.
+ * The vertices are sorted by id, so an id is found by binary search without
+ * building anything. All the numbers use the native byte order.
+ */
+struct snapshot_header {
+    /** SNAPSHOT_MAGIC, including its terminator. */
+    char magic[8];
+    /** SNAPSHOT_VERSION of the code that wrote the file. */
+    uint32_t version;
+    /** The amount of vertices. */
+    int32_t verticesNumber;
+    /** The length of the CSR neighbors array. */
+    int64_t neighborsNumber;
+    /** The length of the ids section. */
+    int64_t idsLength;
+};
+typedef struct snapshot_header SnapshotHeader;
+
+/**
+ * @brief Position of each section on a snapshot file.
+ */
+struct snapshot_layout {
+    size_t idOffsets;
+    size_t ages;
+    size_t offsets;
+    size_t neighbors;
+    size_t ids;
+    /** The expected length of the file. */
+    size_t length;
+};
+typedef struct snapshot_layout SnapshotLayout;
+
+/**
+ * @brief Snapshot structure. The people table and the CSR graph are views
+ * over the mapped file.
+ */
+struct snapshot {
+    /** The mapped file. */
+    void *mapping;
+    /** Length of the mapping. */
+    size_t mappingLength;
+    /** People table over the mapped ages, id offsets and ids. */
+    PersonTable *table;
+    /** CSR graph over the mapped arrays. */
+    CsrGraph *graph;
+};
+
+/**
+ * @brief Rounds the given position up to a multiple of 8.
+ */
+static size_t Snapshot_align(size_t position) {
+    return (position + 7) & ~(size_t) 7;
+}
+
+/**
+ * @brief Calculates the position of each section given the header.
+ *
+ * Complexity: O(1).
+ *
+ * @param header The header.
+ * @return SnapshotLayout The sections positions.
+ */
+static SnapshotLayout Snapshot_getLayout(SnapshotHeader *header) {
+    SnapshotLayout layout;
+    size_t n = header->verticesNumber;
+
+    layout.idOffsets = Snapshot_align(sizeof(SnapshotHeader));
+    layout.ages = Snapshot_align(layout.idOffsets + (n + 1) * sizeof(int64_t));
+    layout.offsets = Snapshot_align(layout.ages + n * sizeof(int32_t));
+    layout.neighbors = Snapshot_align(layout.offsets +
+        (n + 1) * sizeof(int32_t));
+    layout.ids = Snapshot_align(layout.neighbors +
+        header->neighborsNumber * sizeof(int32_t));
+    layout.length = layout.ids + header->idsLength;
+
+    return layout;
+}
+
+/**
+ * @brief Writes the given array on the file, preceded by the zero padding
+ * needed to reach its section position.
+ *
+ * @param file The file.
+ * @param position The section position.
+ * @param data The array.
+ * @param length The array length, in bytes.
+ * @return int 1 on success, 0 otherwise.
+ */
+static int Snapshot_writeSection(FILE *file, size_t position, const void *data,
+    size_t length) {
+    static const char padding[8] = {0};
+    long current = ftell(file);
+
+    if (current < 0 || (size_t) current > position ||
+        fwrite(padding, 1, position - current, file) != position - current) {
+        return 0;
+    }
+    return fwrite(data, 1, length, file) == length;
+}
+
+/**
+ * @brief Table being written, used by the sort comparison.
+ */
+static PersonTable *snapshot_sort_table;
+
+/**
+ * @brief Compares two people indices by their ids.
+ */
+static int Snapshot_compareIds(const void *a, const void *b) {
+    return strcmp(PersonTable_getId(snapshot_sort_table, *(const int *) a),
+        PersonTable_getId(snapshot_sort_table, *(const int *) b));
+}
+
+/**
+ * @brief Writes a snapshot of the loaded people and graph.
+ *
+ * If the people are not sorted by id (for example, when the hash index was
+ * used), the vertices are renumbered in the id order on the snapshot.
+ *
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * Complexity: O(V+E) if the graph is sorted, O(V*log(V)+E) otherwise.
+ *
+ * @param path The snapshot file path.
+ * @param table The table holding the people.
+ * @param csr The built CSR graph holding the edges, with the same indices.
+ * @return int 1 on success, 0 if the file could not be written.
+ */
+int Snapshot_write(const char *path, PersonTable *table, CsrGraph *csr) {
+    int n = PersonTable_getLength(table);
+    int *order = (int *) malloc((n + 1) * sizeof(int));
+    int *positions = (int *) malloc((n + 1) * sizeof(int));
+    int i, sorted = 1;
+
+    for (i = 0; i < n; i += 1) {
+        order[i] = i;
+        if (i > 0 && strcmp(PersonTable_getId(table, i - 1),
+            PersonTable_getId(table, i)) > 0) {
+            sorted = 0;
+        }
+    }
+    if (!sorted) {
+        snapshot_sort_table = table;
+        qsort(order, n, sizeof(int), Snapshot_compareIds);
+    }
+    for (i = 0; i < n; i += 1) {
+        positions[order[i]] = i;
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(SnapshotHeader));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.verticesNumber = n;
+    header.neighborsNumber = CsrGraph_getNeighborsNumber(csr);
+
+    int64_t *idOffsets = (int64_t *) malloc((n + 1) * sizeof(int64_t));
+    int32_t *ages = (int32_t *) malloc((n + 1) * sizeof(int32_t));
+    int32_t *offsets = (int32_t *) malloc((n + 1) * sizeof(int32_t));
+    int32_t *neighbors = (int32_t *) malloc(
+        (header.neighborsNumber + 1) * sizeof(int32_t));
+
+    idOffsets[0] = 0;
+    offsets[0] = 0;
+    for (i = 0; i < n; i += 1) {
+        int degree = CsrGraph_getDegree(csr, order[i]);
+        int *related = CsrGraph_getNeighbors(csr, order[i]);
+
+        idOffsets[i + 1] = idOffsets[i] +
+            strlen(PersonTable_getId(table, order[i])) + 1;
+        ages[i] = PersonTable_getAge(table, order[i]);
+        offsets[i + 1] = offsets[i] + degree;
+        for (int j = 0; j < degree; j += 1) {
+            neighbors[offsets[i] + j] = positions[related[j]];
+        }
+    }
+    header.idsLength = idOffsets[n];
+
+    SnapshotLayout layout = Snapshot_getLayout(&header);
+    FILE *file = fopen(path, "wb");
+    int success = file != NULL &&
+        fwrite(&header, sizeof(SnapshotHeader), 1, file) == 1 &&
+        Snapshot_writeSection(file, layout.idOffsets, idOffsets,
+            (n + 1) * sizeof(int64_t)) &&
+        Snapshot_writeSection(file, layout.ages, ages, n * sizeof(int32_t)) &&
+        Snapshot_writeSection(file, layout.offsets, offsets,
+            (n + 1) * sizeof(int32_t)) &&
+        Snapshot_writeSection(file, layout.neighbors, neighbors,
+            header.neighborsNumber * sizeof(int32_t)) &&
+        Snapshot_writeSection(file, layout.ids, "", 0);
+
+    for (i = 0; success && i < n; i += 1) {
+        char *id = PersonTable_getId(table, order[i]);
+        success = fwrite(id, 1, strlen(id) + 1, file) == strlen(id) + 1;
+    }
+    if (file != NULL && fclose(file) != 0) {
+        success = 0;
+    }
+
+    free(order);
+    free(positions);
+    free(idOffsets);
+    free(ages);
+    free(offsets);
+    free(neighbors);
+
+    return success;
+}
+
+/**
+ * @brief Checks that the mapped sections can be read without leaving the
+ * mapping: the id offsets and the CSR offsets start on 0, never decrease and
+ * end on the section lengths, every id is terminated, and every neighbor is a
+ * vertex index.
+ *
+ * V: The vertices number.
+ * E: The neighbors number.
+ * Complexity: O(V+E).
+ *
+ * @param header The header, already checked against the file length.
+ * @param base The start of the mapping.
+ * @param layout The sections positions.
+ * @return int 1 if the sections are consistent, 0 otherwise.
+ */
+static int Snapshot_validate(SnapshotHeader *header, char *base,
+    SnapshotLayout layout) {
+    int n = header->verticesNumber;
+    int64_t *idOffsets = (int64_t *) (base + layout.idOffsets);
+    int32_t *offsets = (int32_t *) (base + layout.offsets);
+    int32_t *neighbors = (int32_t *) (base + layout.neighbors);
+    char *ids = base + layout.ids;
+
+    if (idOffsets[0] != 0 || idOffsets[n] != header->idsLength ||
+        offsets[0] != 0 || offsets[n] != header->neighborsNumber) {
+        return 0;
+    }
+    for (int i = 0; i < n; i += 1) {
+        if (idOffsets[i + 1] <= idOffsets[i] ||
+            idOffsets[i + 1] > header->idsLength ||
+            ids[idOffsets[i + 1] - 1] != '\0' ||
+            offsets[i + 1] < offsets[i]) {
+            return 0;
+        }
+    }
+    for (int64_t j = 0; j < header->neighborsNumber; j += 1) {
+        if (neighbors[j] < 0 || neighbors[j] >= n) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Opens a snapshot, mapping the file read only.
+ *
+ * The header is validated against the file length, and the offsets and
+ * neighbors against the sections bounds, with a single sequential read of
+ * the arrays. The people and the edges are not copied: the queries read
+ * them from the mapping.
+ *
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * Complexity: O(V+E).
+ *
+ * @param path The snapshot file path.
+ * @return Snapshot* A pointer to the opened snapshot. NULL if the file could
+ * not be mapped, is not a snapshot of the current version or is corrupted.
+ */
+Snapshot * Snapshot_open(const char *path) {
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) {
+        return NULL;
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 ||
+        (size_t) status.st_size < sizeof(SnapshotHeader)) {
+        close(descriptor);
+        return NULL;
+    }
+
+    void *mapping = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED,
+        descriptor, 0);
+    close(descriptor);
+    if (mapping == MAP_FAILED) {
+        return NULL;
+    }
+
+    SnapshotHeader *header = (SnapshotHeader *) mapping;
+    SnapshotLayout layout = Snapshot_getLayout(header);
+    if (
+        memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        header->version != SNAPSHOT_VERSION ||
+        header->verticesNumber < 0 ||
+        header->neighborsNumber < 0 ||
+        header->neighborsNumber > INT32_MAX ||
+        header->idsLength < 0 ||
+        layout.length != (size_t) status.st_size ||
+        !Snapshot_validate(header, (char *) mapping, layout)
+    ) {
+        munmap(mapping, status.st_size);
+        return NULL;
+    }
+
+    char *base = (char *) mapping;
+    Snapshot *snapshot = (Snapshot *) malloc(sizeof(Snapshot));
+    snapshot->mapping = mapping;
+    snapshot->mappingLength = status.st_size;
+    snapshot->table = PersonTable_createView(header->verticesNumber,
+        (int *) (base + layout.ages), (int64_t *) (base + layout.idOffsets),
+        base + layout.ids);
+    snapshot->graph = CsrGraph_createView(header->verticesNumber,
+        (int *) (base + layout.offsets), (int *) (base + layout.neighbors));
+
+    return snapshot;
+}
+
+/**
+ * @brief Closes the snapshot, unmapping the file.
+ *
+ * Complexity: O(1).
+ *
+ * @param snapshot The snapshot to be closed.
+ */
+void Snapshot_close(Snapshot *snapshot) {
+    PersonTable_destroy(snapshot->table);
+    CsrGraph_destroy(snapshot->graph);
+    munmap(snapshot->mapping, snapshot->mappingLength);
+    free(snapshot);
+}
+
+/**
+ * @brief Getter for the people table over the mapped people.
+ *
+ * Complexity: O(1).
+ *
+ * @param snapshot The snapshot.
+ * @return PersonTable* The table. It belongs to the snapshot.
+ */
+PersonTable * Snapshot_getTable(Snapshot *snapshot) {
+    return snapshot->table;
+}
+
+/**
+ * @brief Getter for the CSR graph over the mapped edges.
+ *
+ * Complexity: O(1).
+ *
+ * @param snapshot The snapshot.
+ * @return CsrGraph* The graph. It belongs to the snapshot.
+ */
+CsrGraph * Snapshot_getGraph(Snapshot *snapshot) {
+    return snapshot->graph;
+}
+
+/**
+ * @brief Search the vertex index of the given id, using the binary search
+ * over the sorted string table.
+ *
+ * n: The amount of vertices.
+ * Complexity: O(log(n)).
+ *
+ * @param snapshot The snapshot.
+ * @param id The person's id.
+ * @return int The vertex index. -1 if not found.
+ */
+int Snapshot_searchId(Snapshot *snapshot, char *id) {
+    return PersonTable_searchId(snapshot->table, id);
+}
+
+/**
+ * @brief Spread the music hit given the first person's vertex index, with the
+ * same rules as Person_spreadMusic, over the mapped arrays. The listened
+ * marks of the previous spread are reset first.
+ *
+ * V: The graph's vertices number.
+ * E: The graph's edges number.
+ * Complexity: O(V+E).
+ *
+ * @param snapshot The snapshot.
+ * @param vertex The index of the person who first listened the music.
+ * @return int How many people liked the music.
+ */
+int Snapshot_spreadMusic(Snapshot *snapshot, int vertex) {
+    PersonTable_resetSpread(snapshot->table);
+    return PersonTable_spreadMusic(snapshot->table, snapshot->graph, vertex,
+        SPREAD_DFS);
+}
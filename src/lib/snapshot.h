@@ -0,0 +1,26 @@
+#include "csr_graph.h"
+#include "person_table.h"
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+/** Version of the snapshot format written by this code. */
+#define SNAPSHOT_VERSION 1
+
+typedef struct snapshot Snapshot;
+
+int Snapshot_write(const char *path, PersonTable *table, CsrGraph *csr);
+
+Snapshot * Snapshot_open(const char *path);
+
+void Snapshot_close(Snapshot *snapshot);
+
+PersonTable * Snapshot_getTable(Snapshot *snapshot);
+
+CsrGraph * Snapshot_getGraph(Snapshot *snapshot);
+
+int Snapshot_searchId(Snapshot *snapshot, char *id);
+
+int Snapshot_spreadMusic(Snapshot *snapshot, int vertex);
+
+#endif
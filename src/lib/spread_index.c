@@ -0,0 +1,308 @@
+#include <stdlib.h>
+#include <string.h>
+#include "spread_index.h"
+
+/**
+ * @brief SpreadIndex structure.
+ *
+ * Disjoint sets (union-find) over the eligible vertices, where two eligible
+ * vertices are on the same set if they are connected by a path of eligible
+ * vertices. Since the spread only goes through eligible vertices and only
+ * counts them, the spread count of an eligible vertex is the size of its set,
+ * and the count of any other vertex is 0.
+ */
+struct spread_index {
+    /** The amount of vertices. */
+    int verticesNumber;
+    /** Flag per vertex, 1 if the spread goes through it. */
+    unsigned char *eligible;
+    /** Parent of each vertex on its set tree. Roots are their own parent. */
+    int *parents;
+    /** Size of the set of each root. */
+    int *sizes;
+    /** Count of each vertex, available after SpreadIndex_build. */
+    int *counts;
+    /** First registered seed of the set of each root, or -1. */
+    int *seedHeads;
+    /** Last registered seed of the set of each root. */
+    int *seedTails;
+    /** Vertex of each registered seed. */
+    int *seedVertices;
+    /** Next registered seed on the same set, or -1. */
+    int *seedNext;
+    /** Current spread count of each registered seed. */
+    int *seedCounts;
+    /** Amount of registered seeds. */
+    int seedsNumber;
+    /** Allocated amount of registered seeds. */
+    int seedsCapacity;
+};
+
+/**
+ * @brief Creates an index where each vertex is alone on its set.
+ *
+ * n: The amount of vertices.
+ * Complexity: O(n).
+ *
+ * @param eligible Flag per vertex, 1 if the spread goes through it. It is
+ * copied.
+ * @param verticesNumber The amount of vertices.
+ * @return SpreadIndex* A pointer to the created index.
+ */
+SpreadIndex * SpreadIndex_create(const unsigned char *eligible,
+    int verticesNumber) {
+    SpreadIndex *index = (SpreadIndex *) malloc(sizeof(SpreadIndex));
+    index->verticesNumber = verticesNumber;
+    index->eligible = (unsigned char *) malloc(verticesNumber + 1);
+    index->parents = (int *) malloc((verticesNumber + 1) * sizeof(int));
+    index->sizes = (int *) malloc((verticesNumber + 1) * sizeof(int));
+    index->counts = NULL;
+    index->seedHeads = NULL;
+    index->seedTails = NULL;
+    index->seedVertices = NULL;
+    index->seedNext = NULL;
+    index->seedCounts = NULL;
+    index->seedsNumber = 0;
+    index->seedsCapacity = 0;
+
+    memcpy(index->eligible, eligible, verticesNumber);
+    for (int i = 0; i < verticesNumber; i += 1) {
+        index->parents[i] = i;
+        index->sizes[i] = 1;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Destroys the given index.
+ *
+ * Complexity: O(1).
+ *
+ * @param index The index to be destroyed.
+ */
+void SpreadIndex_destroy(SpreadIndex *index) {
+    free(index->eligible);
+    free(index->parents);
+    free(index->sizes);
+    free(index->counts);
+    free(index->seedHeads);
+    free(index->seedTails);
+    free(index->seedVertices);
+    free(index->seedNext);
+    free(index->seedCounts);
+    free(index);
+}
+
+/**
+ * @brief Finds the root of the set of the given vertex, halving the path on
+ * the way.
+ *
+ * Complexity: O(α(n)) amortized.
+ *
+ * @param index The index.
+ * @param vertex The vertex.
+ * @return int The root of the vertex set.
+ */
+static int SpreadIndex_find(SpreadIndex *index, int vertex) {
+    int *parents = index->parents;
+    while (parents[vertex] != vertex) {
+        parents[vertex] = parents[parents[vertex]];
+        vertex = parents[vertex];
+    }
+    return vertex;
+}
+
+/**
+ * @brief Registers an edge. If both vertices are eligible, their sets are
+ * merged, the smaller one under the larger one. The counts built before are
+ * discarded.
+ *
+ * The registered seeds of both sets are joined on a single list, and their
+ * counts are updated to the size of the merged set.
+ *
+ * s: The amount of registered seeds on the merged set.
+ * Complexity: O(α(n)+s) amortized.
+ *
+ * @param index The index.
+ * @param vertex1 A vertex of the edge.
+ * @param vertex2 The other vertex of the edge.
+ * @return int The root of the merged set, or -1 if no set changed.
+ */
+int SpreadIndex_insertEdge(SpreadIndex *index, int vertex1, int vertex2) {
+    if (!index->eligible[vertex1] || !index->eligible[vertex2]) {
+        return -1;
+    }
+
+    int root1 = SpreadIndex_find(index, vertex1);
+    int root2 = SpreadIndex_find(index, vertex2);
+    if (root1 == root2) {
+        return -1;
+    }
+
+    if (index->sizes[root1] < index->sizes[root2]) {
+        int root = root1;
+        root1 = root2;
+        root2 = root;
+    }
+    index->parents[root2] = root1;
+    index->sizes[root1] += index->sizes[root2];
+
+    if (index->counts) {
+        free(index->counts);
+        index->counts = NULL;
+    }
+
+    if (index->seedHeads && index->seedHeads[root2] != -1) {
+        if (index->seedHeads[root1] == -1) {
+            index->seedHeads[root1] = index->seedHeads[root2];
+        } else {
+            index->seedNext[index->seedTails[root1]] = index->seedHeads[root2];
+        }
+        index->seedTails[root1] = index->seedTails[root2];
+        index->seedHeads[root2] = -1;
+    }
+    if (index->seedHeads) {
+        for (int seed = index->seedHeads[root1]; seed != -1;
+            seed = index->seedNext[seed]) {
+            index->seedCounts[seed] = index->sizes[root1];
+        }
+    }
+
+    return root1;
+}
+
+/**
+ * @brief Precomputes the spread count of every vertex, so SpreadIndex_getCount
+ * becomes a single array access.
+ *
+ * n: The amount of vertices.
+ * Complexity: O(n*α(n)).
+ *
+ * @param index The index.
+ */
+void SpreadIndex_build(SpreadIndex *index) {
+    if (index->counts == NULL) {
+        index->counts = (int *) malloc((index->verticesNumber + 1) *
+            sizeof(int));
+    }
+
+    for (int i = 0; i < index->verticesNumber; i += 1) {
+        index->counts[i] = index->eligible[i] ?
+            index->sizes[SpreadIndex_find(index, i)] : 0;
+    }
+}
+
+/**
+ * @brief Getter for the spread count of the given vertex: how many people
+ * would like the music if it started on it.
+ *
+ * Complexity: O(1) after SpreadIndex_build, O(α(n)) amortized otherwise.
+ *
+ * @param index The index.
+ * @param vertex The vertex who first listened the music.
+ * @return int The spread count.
+ */
+int SpreadIndex_getCount(SpreadIndex *index, int vertex) {
+    if (index->counts) {
+        return index->counts[vertex];
+    }
+    if (!index->eligible[vertex]) {
+        return 0;
+    }
+    return index->sizes[SpreadIndex_find(index, vertex)];
+}
+
+/**
+ * @brief Registers a seed, whose spread count is kept up to date by
+ * SpreadIndex_insertEdge, so it can be read at any time with
+ * SpreadIndex_getSeedCount.
+ *
+ * n: The amount of vertices.
+ * Complexity: O(α(n)) amortized, plus O(n) on the first registration.
+ *
+ * @param index The index.
+ * @param vertex The vertex who first listens the music.
+ * @return int The seed handle. The handles are given in order, from 0.
+ */
+int SpreadIndex_registerSeed(SpreadIndex *index, int vertex) {
+    int seed = index->seedsNumber;
+
+    if (index->seedHeads == NULL) {
+        index->seedHeads = (int *) malloc((index->verticesNumber + 1) *
+            sizeof(int));
+        index->seedTails = (int *) malloc((index->verticesNumber + 1) *
+            sizeof(int));
+        for (int i = 0; i < index->verticesNumber; i += 1) {
+            index->seedHeads[i] = -1;
+        }
+    }
+    if (index->seedsNumber == index->seedsCapacity) {
+        index->seedsCapacity = index->seedsCapacity * 2 + 16;
+        index->seedVertices = (int *) realloc(index->seedVertices,
+            index->seedsCapacity * sizeof(int));
+        index->seedNext = (int *) realloc(index->seedNext,
+            index->seedsCapacity * sizeof(int));
+        index->seedCounts = (int *) realloc(index->seedCounts,
+            index->seedsCapacity * sizeof(int));
+    }
+
+    index->seedVertices[seed] = vertex;
+    index->seedNext[seed] = -1;
+    index->seedCounts[seed] = 0;
+    index->seedsNumber += 1;
+
+    // Ineligible seeds never spread, so they are kept out of the lists.
+    if (index->eligible[vertex]) {
+        int root = SpreadIndex_find(index, vertex);
+        if (index->seedHeads[root] == -1) {
+            index->seedHeads[root] = seed;
+        } else {
+            index->seedNext[index->seedTails[root]] = seed;
+        }
+        index->seedTails[root] = seed;
+        index->seedCounts[seed] = index->sizes[root];
+    }
+
+    return seed;
+}
+
+/**
+ * @brief Getter for the current spread count of a registered seed.
+ *
+ * Complexity: O(1).
+ *
+ * @param index The index.
+ * @param seed The seed handle.
+ * @return int The spread count.
+ */
+int SpreadIndex_getSeedCount(SpreadIndex *index, int seed) {
+    return index->seedCounts[seed];
+}
+
+/**
+ * @brief Getter for the first registered seed of the set of the given root,
+ * as returned by SpreadIndex_insertEdge.
+ *
+ * Complexity: O(1).
+ *
+ * @param index The index.
+ * @param root The set root.
+ * @return int The seed handle, or -1 if the set has no registered seed.
+ */
+int SpreadIndex_getFirstSeed(SpreadIndex *index, int root) {
+    return index->seedHeads ? index->seedHeads[root] : -1;
+}
+
+/**
+ * @brief Getter for the next registered seed on the same set.
+ *
+ * Complexity: O(1).
+ *
+ * @param index The index.
+ * @param seed The seed handle.
+ * @return int The next seed handle, or -1 if it is the last one.
+ */
+int SpreadIndex_getNextSeed(SpreadIndex *index, int seed) {
+    return index->seedNext[seed];
+}
@@ -0,0 +1,25 @@
+#ifndef SPREAD_INDEX_H
+#define SPREAD_INDEX_H
+
+typedef struct spread_index SpreadIndex;
+
+SpreadIndex * SpreadIndex_create(const unsigned char *eligible,
+    int verticesNumber);
+
+void SpreadIndex_destroy(SpreadIndex *index);
+
+int SpreadIndex_insertEdge(SpreadIndex *index, int vertex1, int vertex2);
+
+void SpreadIndex_build(SpreadIndex *index);
+
+int SpreadIndex_getCount(SpreadIndex *index, int vertex);
+
+int SpreadIndex_registerSeed(SpreadIndex *index, int vertex);
+
+int SpreadIndex_getSeedCount(SpreadIndex *index, int seed);
+
+int SpreadIndex_getFirstSeed(SpreadIndex *index, int root);
+
+int SpreadIndex_getNextSeed(SpreadIndex *index, int seed);
+
+#endif
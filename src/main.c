@@ -1,63 +1,1479 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include "lib/list.h"
 #include "lib/graph.h"
+#include "lib/csr_graph.h"
 #include "lib/person.h"
+#include "lib/input.h"
+#include "lib/arena.h"
+#include "lib/spread_index.h"
+#include "lib/parallel_loader.h"
+#include "lib/snapshot.h"
+#include "lib/person_table.h"
+#include "lib/person_graph.h"
+#include "lib/metrics.h"
+#include "lib/external_graph.h"
+#include "lib/parallel_bfs.h"
+#include "lib/reorder.h"
+#include "lib/compact_graph.h"
+#include "lib/server.h"
+#include "lib/pipeline.h"
 
 /**
- * @brief Main funcition.
- * 
- * It will create and destroy the graph, the vertices and the edges given the
- * user entries, and it will calculate how many people liked the music hit after
- * the spread.
- * 
- * Final complexity: O(E*V*log(V)), being V = "n" and E = "m". The most
- * expensive parts are the vertices array sort and edges processing.
- * 
+ * @brief Options given by the program arguments.
+ */
+struct options {
+    /** If 1, the edges are stored on a CSR graph. */
+    int csr;
+    /** If 1, the people are found through a hash index. */
+    int hash;
+    /** If 1, the spread uses the recursive traversal. */
+    int recursive;
+    /** If 1, the spread uses the multithreaded traversal. */
+    int parallel;
+    /** Amount of threads of the multithreaded traversal. */
+    int threads;
+    /** SPREAD_DFS or SPREAD_BFS, for the iterative traversals. */
+    int strategy;
+    /** If 1, the people, vertices and lists are allocated on an arena. */
+    int arena;
+    /** If 1, every id after the edges is a spread query. */
+    int batch;
+    /** If 1, the batch queries are answered 64 at a time by a bit parallel
+     * spread. */
+    int multiSeed;
+    /** If 1, the edges are loaded into the CSR graph by several threads. */
+    int parallelLoad;
+    /** If 1, the counts are answered by a precomputed spread index. */
+    int index;
+    /** If 1, the queries are "ID THRESHOLD" pairs answered by an age index. */
+    int ageIndex;
+    /** If 1, the people are stored on a person table instead of vertices. */
+    int table;
+    /** If 1, the input is read on a sliding window and no edge is stored. */
+    int stream;
+    /** SORT_QUICKSORT or SORT_MULTIKEY, for the people ids sort. */
+    int sort;
+    /** REORDER_NONE, REORDER_RCM or REORDER_DEGREE, for the vertices order
+     * after the edges are loaded. */
+    int reorder;
+    /** If 1, the CSR graph is compressed after the load and the spread
+     * decodes the neighbor lists. */
+    int compact;
+    /** If 1, the people and edges are stored on a mutable person graph. */
+    int dynamic;
+    /** Path of the updates applied to the mutable graph, or NULL. */
+    char *updatesPath;
+    /** Path of the edges inserted after the queries are registered, or NULL. */
+    char *watchPath;
+    /** Directory of the edge partitions of the external mode, or NULL. */
+    char *externalPath;
+    /** Amount of edge partitions of the external mode. */
+    int partitions;
+    /** Path of the input file. NULL for the standard input. */
+    char *inputPath;
+    /** Path of the snapshot written after the load, or NULL. */
+    char *writeSnapshotPath;
+    /** Path of the snapshot loaded instead of the input graph, or NULL. */
+    char *snapshotPath;
+    /** Path of the Unix socket the queries are served on, or NULL. */
+    char *servePath;
+    /** Amount of hops the spread may travel, or -1 for no limit. */
+    int hops;
+};
+typedef struct options Options;
+
+/**
+ * @brief Structures a query on the person table is answered with.
+ */
+struct table_query {
+    /** The options. */
+    Options *options;
+    /** The people. */
+    PersonTable *table;
+    /** The hash index, or NULL. */
+    PersonIndex *index;
+    /** The spread index, or NULL. */
+    SpreadIndex *spreadIndex;
+    /** The CSR graph, or NULL. */
+    CsrGraph *csr;
+    /** The compact graph, or NULL. */
+    CompactGraph *compact;
+    /** The search of "--spread=parallel", or NULL. */
+    ParallelBfs *parallelBfs;
+    /** Receives the count of each hop of a hop limited spread, or NULL. */
+    int *levels;
+};
+typedef struct table_query TableQuery;
+
+/**
+ * @brief Structures a query on the external graph is answered with.
+ */
+struct external_query {
+    /** The people. */
+    PersonTable *table;
+    /** The hash index, or NULL. */
+    PersonIndex *index;
+    /** If each person can spread the music, by table index. */
+    unsigned char *eligible;
+    /** The edges partitions. */
+    ExternalGraph *graph;
+    /** The bitmap of the people reached by a search. */
+    unsigned long long *visited;
+};
+typedef struct external_query ExternalQuery;
+
+/**
+ * @brief Structures a query on the graph is answered with.
+ */
+struct graph_query {
+    /** The people, on the vertices. */
+    Graph *graph;
+    /** The arena the people and vertices are allocated on, or NULL. */
+    Arena *arena;
+    /** The hash index, or NULL. */
+    PersonIndex *index;
+    /** The spread index, or NULL. */
+    SpreadIndex *spreadIndex;
+    /** The age index, or NULL. */
+    AgeIndex *ageIndex;
+    /** The CSR graph, or NULL. */
+    CsrGraph *csr;
+    /** The compact graph, or NULL. */
+    CompactGraph *compact;
+    /** The search of "--spread=parallel", or NULL. */
+    ParallelBfs *parallelBfs;
+    /** Receives the count of each hop of a hop limited spread, or NULL. */
+    int *levels;
+};
+typedef struct graph_query GraphQuery;
+
+/**
+ * @brief Parses a whole argument value as an integer.
+ *
+ * @param text The argument value.
+ * @param minimum The smallest value accepted.
+ * @param value Receives the parsed value.
+ * @return int 1 on success, 0 if the text is not an integer between minimum
+ * and INT_MAX - 1.
+ */
+static int parseInteger(const char *text, int minimum, int *value) {
+    char *end;
+    long number = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || number < minimum ||
+        number >= INT_MAX) {
+        return 0;
+    }
+    *value = (int) number;
+    return 1;
+}
+
+/**
+ * @brief Parses the program arguments.
+ *
+ * @param argc The arguments count.
+ * @param argv The arguments.
+ * @param options Receives the parsed options.
+ * @return int 1 on success, 0 if an argument is unknown.
+ */
+static int parseOptions(int argc, char *argv[], Options *options) {
+    options->csr = 0;
+    options->hash = 0;
+    options->recursive = 0;
+    options->parallel = 0;
+    options->threads = 1;
+    options->strategy = SPREAD_DFS;
+    options->arena = 0;
+    options->batch = 0;
+    options->multiSeed = 0;
+    options->index = 0;
+    options->ageIndex = 0;
+    options->table = 0;
+    options->stream = 0;
+    options->sort = SORT_QUICKSORT;
+    options->reorder = REORDER_NONE;
+    options->compact = 0;
+    options->dynamic = 0;
+    options->updatesPath = NULL;
+    options->watchPath = NULL;
+    options->parallelLoad = 0;
+    options->externalPath = NULL;
+    options->partitions = EXTERNAL_GRAPH_PARTITIONS;
+    options->inputPath = NULL;
+    options->writeSnapshotPath = NULL;
+    options->snapshotPath = NULL;
+    options->servePath = NULL;
+    options->hops = -1;
+
+    for (int i = 1; i < argc; i += 1) {
+        if (strcmp(argv[i], "--csr") == 0) {
+            options->csr = 1;
+        } else if (strcmp(argv[i], "--hash") == 0) {
+            options->hash = 1;
+        } else if (strcmp(argv[i], "--spread=dfs") == 0) {
+            options->strategy = SPREAD_DFS;
+            options->recursive = options->parallel = 0;
+        } else if (strcmp(argv[i], "--spread=bfs") == 0) {
+            options->strategy = SPREAD_BFS;
+            options->recursive = options->parallel = 0;
+        } else if (strcmp(argv[i], "--spread=recursive") == 0) {
+            options->recursive = 1;
+            options->parallel = 0;
+        } else if (strcmp(argv[i], "--spread=parallel") == 0) {
+            options->parallel = 1;
+            options->recursive = 0;
+            options->csr = 1;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            if (!parseInteger(argv[i] + 10, 1, &options->threads)) {
+                fprintf(stderr, "Invalid amount of threads: %s\n",
+                    argv[i] + 10);
+                return 0;
+            }
+        } else if (strcmp(argv[i], "--arena") == 0) {
+            options->arena = 1;
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            options->batch = 1;
+        } else if (strcmp(argv[i], "--multi-seed") == 0) {
+            options->multiSeed = 1;
+            options->batch = 1;
+            options->csr = 1;
+        } else if (strcmp(argv[i], "--parallel-load") == 0) {
+            options->parallelLoad = 1;
+            options->csr = 1;
+        } else if (strcmp(argv[i], "--index") == 0) {
+            options->index = 1;
+        } else if (strcmp(argv[i], "--age-index") == 0) {
+            options->ageIndex = 1;
+            options->batch = 1;
+        } else if (strcmp(argv[i], "--table") == 0) {
+            options->table = 1;
+            options->csr = 1;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            options->stream = 1;
+            options->table = 1;
+            options->index = 1;
+            options->csr = 1;
+        } else if (strcmp(argv[i], "--sort=quicksort") == 0) {
+            options->sort = SORT_QUICKSORT;
+        } else if (strcmp(argv[i], "--sort=multikey") == 0) {
+            options->sort = SORT_MULTIKEY;
+        } else if (strcmp(argv[i], "--reorder=rcm") == 0) {
+            options->reorder = REORDER_RCM;
+            options->csr = 1;
+        } else if (strcmp(argv[i], "--reorder=degree") == 0) {
+            options->reorder = REORDER_DEGREE;
+            options->csr = 1;
+        } else if (strcmp(argv[i], "--compact") == 0) {
+            options->compact = 1;
+            options->csr = 1;
+        } else if (strcmp(argv[i], "--dynamic") == 0) {
+            options->dynamic = 1;
+        } else if (strncmp(argv[i], "--updates=", 10) == 0) {
+            options->updatesPath = argv[i] + 10;
+            options->dynamic = 1;
+        } else if (strncmp(argv[i], "--watch=", 8) == 0) {
+            options->watchPath = argv[i] + 8;
+            options->index = 1;
+            options->batch = 1;
+        } else if (strncmp(argv[i], "--external=", 11) == 0) {
+            options->externalPath = argv[i] + 11;
+        } else if (strncmp(argv[i], "--partitions=", 13) == 0) {
+            if (!parseInteger(argv[i] + 13, 1, &options->partitions)) {
+                fprintf(stderr, "Invalid amount of partitions: %s\n",
+                    argv[i] + 13);
+                return 0;
+            }
+        } else if (strncmp(argv[i], "--input=", 8) == 0) {
+            options->inputPath = argv[i] + 8;
+        } else if (strncmp(argv[i], "--write-snapshot=", 17) == 0) {
+            options->writeSnapshotPath = argv[i] + 17;
+            options->table = 1;
+            options->csr = 1;
+        } else if (strncmp(argv[i], "--snapshot=", 11) == 0) {
+            options->snapshotPath = argv[i] + 11;
+        } else if (strncmp(argv[i], "--serve=", 8) == 0) {
+            options->servePath = argv[i] + 8;
+            options->table = 1;
+            options->batch = 1;
+            options->csr = 1;
+        } else if (strncmp(argv[i], "--hops=", 7) == 0) {
+            if (!parseInteger(argv[i] + 7, 0, &options->hops)) {
+                fprintf(stderr, "Invalid hop limit: %s\n", argv[i] + 7);
+                return 0;
+            }
+        } else {
+            fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 0;
+        }
+    }
+
+    // The watched seeds live on the spread index of the vertices or the table.
+    if (options->watchPath && (options->dynamic || options->externalPath ||
+        options->snapshotPath)) {
+        fprintf(stderr, "--watch can not be used with --dynamic, --external "
+            "or --snapshot\n");
+        return 0;
+    }
+
+    // The thresholds are answered by the age index, built only over the
+    // vertices of the graph.
+    if (options->ageIndex && (options->index || options->watchPath ||
+        options->stream || options->table || options->servePath ||
+        options->writeSnapshotPath || options->multiSeed ||
+        options->dynamic || options->externalPath || options->snapshotPath)) {
+        fprintf(stderr, "--age-index can not be used with --index, --watch, "
+            "--stream, --table, --serve, --write-snapshot, --multi-seed, "
+            "--dynamic, --external or --snapshot\n");
+        return 0;
+    }
+
+    // The levels come from a sequential traversal over stored edges.
+    if (options->hops >= 0 && (options->index || options->stream ||
+        options->watchPath || options->ageIndex || options->multiSeed ||
+        options->parallel || options->dynamic || options->externalPath ||
+        options->snapshotPath)) {
+        fprintf(stderr, "--hops can not be used with --index, --stream, "
+            "--watch, --age-index, --multi-seed, --spread=parallel, "
+            "--dynamic, --external or --snapshot\n");
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Spreads the music from the given person up to the hop limit of the
+ * options, counting the people of each hop.
+ *
+ * @param options The options.
+ * @param graph The graph.
+ * @param csr The CSR graph, or NULL if the edges are on the vertices lists.
+ * @param start_index The vertex index of the person who first listened.
+ * @param levels Receives the count of each hop.
+ * @return int How many people liked the music within the hop limit.
+ */
+static int spreadLevels(Options *options, Graph *graph, CsrGraph *csr,
+    int start_index, int *levels) {
+    if (csr) {
+        return Person_spreadMusicCsrLevels(graph, csr, start_index,
+            options->hops, levels);
+    }
+    return Person_spreadMusicLevels(Graph_getVertices(graph)[start_index],
+        options->hops, levels);
+}
+
+/**
+ * @brief Prints the cumulative counts of a hop limited spread on a line: how
+ * many people liked the music within 0, 1, ..., hops hops. The counts stop at
+ * the last hop reached, since the later ones would repeat the total.
+ *
+ * @param levels The count of each hop, up to the first empty one. Only the
+ * first count is read if it is 0, as for an unknown id, so the later ones
+ * may be left from a previous query.
+ * @param hops The hop limit.
+ */
+static void printLevels(const int *levels, int hops) {
+    int total = levels[0];
+    printf("%d", total);
+    for (int hop = 1; hop <= hops && levels[hop - 1] > 0 && levels[hop] > 0;
+        hop += 1) {
+        total += levels[hop];
+        printf(" %d", total);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Relabels the vertices and the CSR graph on the order selected by the
+ * options. The people are no longer sorted by id, so the hash index is
+ * rebuilt, or built if the binary search was used.
+ *
+ * @param options The options.
+ * @param graph The graph.
+ * @param csr The CSR graph. Receives the relabeled one.
+ * @param index The hash index, or NULL. Receives the rebuilt one.
+ */
+static void reorderGraph(Options *options, Graph *graph, CsrGraph **csr,
+    PersonIndex **index) {
+    int *order = (int *) malloc((Graph_getVerticesNumber(graph) + 1) *
+        sizeof(int));
+
+    Reorder_compute(*csr, options->reorder, order);
+    CsrGraph *permuted = Reorder_permuteGraph(*csr, order);
+    CsrGraph_destroy(*csr);
+    *csr = permuted;
+    Graph_permuteVertices(graph, order);
+
+    if (*index) {
+        PersonIndex_destroy(*index);
+    }
+    *index = PersonIndex_create(graph);
+    free(order);
+}
+
+/**
+ * @brief Same as reorderGraph, for the people on a person table.
+ *
+ * @param options The options.
+ * @param table The table. Receives the reordered one.
+ * @param csr The CSR graph. Receives the relabeled one.
+ * @param index The hash index, or NULL. Receives the rebuilt one.
+ */
+static void reorderTable(Options *options, PersonTable **table,
+    CsrGraph **csr, PersonIndex **index) {
+    int *order = (int *) malloc((PersonTable_getLength(*table) + 1) *
+        sizeof(int));
+
+    Reorder_compute(*csr, options->reorder, order);
+    CsrGraph *permuted = Reorder_permuteGraph(*csr, order);
+    CsrGraph_destroy(*csr);
+    *csr = permuted;
+    PersonTable *reordered = PersonTable_createPermuted(*table, order);
+    PersonTable_destroy(*table);
+    *table = reordered;
+
+    if (*index) {
+        PersonIndex_destroy(*index);
+    }
+    *index = PersonIndex_createFromTable(*table);
+    free(order);
+}
+
+/**
+ * @brief Compresses the CSR graph when the spread selected reads the edges one
+ * vertex at a time: the multithreaded, the bit parallel and the hop limited
+ * ones keep the CSR graph. The CSR graph is then released.
+ *
+ * @param options The options.
+ * @param csr The CSR graph. Receives NULL if it was compressed.
+ * @return CompactGraph* The compact graph, or NULL if it was not created.
+ */
+static CompactGraph * compactGraph(Options *options, CsrGraph **csr) {
+    if (!*csr || options->parallel || options->multiSeed ||
+        options->hops >= 0) {
+        return NULL;
+    }
+
+    CompactGraph *compact = CompactGraph_createFromCsr(*csr);
+    if (compact) {
+        CsrGraph_destroy(*csr);
+        *csr = NULL;
+    }
+    return compact;
+}
+
+/**
+ * @brief Reads all the remaining first listeners and answers them together
+ * with the bit parallel spread, printing one count per line in the input
+ * order.
+ *
+ * @param graph The graph, or NULL if the people are on the table.
+ * @param table The person table, or NULL if the people are on the graph.
+ * @param index The hash index, or NULL.
+ * @param csr The CSR graph.
+ * @param input The input.
+ * @param first_id The first listener already read, or NULL.
+ */
+static void spreadSeeds(Graph *graph, PersonTable *table, PersonIndex *index,
+    CsrGraph *csr, Input *input, char *first_id) {
+    int *seeds = NULL;
+    int length = 0, capacity = 0, i;
+
+    while (first_id != NULL) {
+        if (length == capacity) {
+            capacity = capacity == 0 ? 64 : capacity * 2;
+            seeds = (int *) realloc(seeds, capacity * sizeof(int));
+        }
+        if (index) {
+            seeds[length++] = PersonIndex_search(index, first_id);
+        } else if (table) {
+            seeds[length++] = PersonTable_searchId(table, first_id);
+        } else {
+            seeds[length++] = Graph_searchPersonIndexById(graph, first_id);
+        }
+        first_id = Input_nextToken(input, NULL);
+    }
+
+    int *counts = (int *) malloc((length + 1) * sizeof(int));
+    if (table) {
+        PersonTable_spreadMusicMulti(table, csr, seeds, length, counts);
+    } else {
+        Person_spreadMusicMulti(graph, csr, seeds, length, counts);
+    }
+    for (i = 0; i < length; i += 1) {
+        printf("%d\n", counts[i]);
+    }
+
+    free(seeds);
+    free(counts);
+}
+
+/**
+ * @brief Reads all the remaining queries, as "ID THRESHOLD" pairs, and prints
+ * the count of each one with the age index: the people younger than the
+ * threshold reached from the id through people younger than it.
+ *
+ * @param graph The graph.
+ * @param index The hash index, or NULL.
+ * @param age_index The built age index.
+ * @param input The input.
+ * @param first_id The id of the first query already read, or NULL.
+ */
+static void answerThresholds(Graph *graph, PersonIndex *index,
+    AgeIndex *age_index, Input *input, char *first_id) {
+    int threshold = 0;
+
+    while (first_id != NULL && Input_nextInt(input, &threshold)) {
+        int start_index = Pipeline_searchPerson(graph, index, first_id);
+        printf("%d\n", start_index >= 0 ?
+            AgeIndex_getCount(age_index, start_index, threshold) : 0);
+        first_id = Input_nextToken(input, NULL);
+    }
+}
+
+/**
+ * @brief Answers the spread queries over a snapshot. The input holds only the
+ * ids of the first listeners: one, or all of them with "--batch".
+ *
+ * @param options The options.
+ * @param input The input.
+ * @return int Program's exit status code.
+ */
+static int runSnapshot(Options *options, Input *input) {
+    METRICS_PHASE("load");
+    Snapshot *snapshot = Snapshot_open(options->snapshotPath);
+    if (snapshot == NULL) {
+        fprintf(stderr, "Invalid snapshot: %s\n", options->snapshotPath);
+        Input_close(input);
+        return 1;
+    }
+
+    METRICS_PHASE("spread");
+    char *first_id = Input_nextToken(input, NULL);
+    if (first_id == NULL && !options->batch) {
+        printf("0\n");
+    }
+    while (first_id != NULL) {
+        int start_index = Snapshot_searchId(snapshot, first_id);
+        printf("%d\n", start_index >= 0 ?
+            Snapshot_spreadMusic(snapshot, start_index) : 0);
+
+        if (!options->batch) {
+            break;
+        }
+        first_id = Input_nextToken(input, NULL);
+    }
+
+    METRICS_PHASE("teardown");
+    Snapshot_close(snapshot);
+    Input_close(input);
+    return 0;
+}
+
+/**
+ * @brief Inserts the edges of the watch file on the spread index, one per
+ * line, and prints the new count of every registered seed whose count
+ * changed, as "ID COUNT" lines, right after each insertion.
+ *
+ * @param options The options.
+ * @param graph The graph, or NULL if the people are on the table.
+ * @param table The person table, or NULL if the people are on the graph.
+ * @param index The hash index, or NULL.
+ * @param spread_index The spread index, with the seeds registered.
+ * @param seed_ids The id of each registered seed.
+ * @return int Program's exit status code.
+ */
+static int watchEdges(Options *options, Graph *graph, PersonTable *table,
+    PersonIndex *index, SpreadIndex *spread_index, char **seed_ids) {
+    Input *edges = Input_open(options->watchPath);
+    if (edges == NULL) {
+        fprintf(stderr, "Could not open the watched edges: %s\n",
+            options->watchPath);
+        return 1;
+    }
+
+    METRICS_PHASE("watch");
+    while (1) {
+        char *id1 = Input_nextToken(edges, NULL);
+        char *id2 = Input_nextToken(edges, NULL);
+        if (id1 == NULL || id2 == NULL) {
+            break;
+        }
+        int index1 = table ? Pipeline_searchTablePerson(table, index, id1) :
+            Pipeline_searchPerson(graph, index, id1);
+        int index2 = table ? Pipeline_searchTablePerson(table, index, id2) :
+            Pipeline_searchPerson(graph, index, id2);
+        if (index1 < 0 || index2 < 0) {
+            continue;
+        }
+
+        int root = SpreadIndex_insertEdge(spread_index, index1, index2);
+        if (root < 0) {
+            continue;
+        }
+        for (int seed = SpreadIndex_getFirstSeed(spread_index, root);
+            seed != -1; seed = SpreadIndex_getNextSeed(spread_index, seed)) {
+            printf("%s %d\n", seed_ids[seed],
+                SpreadIndex_getSeedCount(spread_index, seed));
+        }
+    }
+
+    Input_close(edges);
+    return 0;
+}
+
+/**
+ * @brief Answers a spread query on the person table with the structures
+ * selected by the options. The listened marks are reset afterwards.
+ *
+ * @param context The TableQuery. Its levels receive the count of each hop of
+ * a hop limited spread, only a 0 if the id is unknown.
+ * @param id The id of the person who first listened the music.
+ * @return int How many people liked the music, within the hop limit if there
+ * is one. 0 if the id is unknown.
+ */
+static int answerTableQuery(void *context, char *id) {
+    TableQuery *query = (TableQuery *) context;
+    Options *options = query->options;
+    int start_index = Pipeline_searchTablePerson(query->table, query->index,
+        id);
+    int counter = 0;
+
+    if (query->levels) {
+        query->levels[0] = 0;
+    }
+    if (start_index < 0) {
+        return 0;
+    }
+    if (query->levels) {
+        return PersonTable_spreadMusicLevels(query->table, query->csr,
+            start_index, options->hops, query->levels);
+    }
+    if (query->spreadIndex) {
+        return SpreadIndex_getCount(query->spreadIndex, start_index);
+    }
+
+    if (query->compact) {
+        counter = PersonTable_spreadMusicCompact(query->table, query->compact,
+            start_index, options->recursive ? SPREAD_DFS : options->strategy);
+    } else if (query->parallelBfs) {
+        counter = PersonTable_spreadMusicParallel(query->table,
+            query->parallelBfs, start_index);
+    } else {
+        counter = PersonTable_spreadMusic(query->table, query->csr,
+            start_index, options->recursive ? SPREAD_DFS : options->strategy);
+    }
+    PersonTable_resetSpread(query->table);
+    return counter;
+}
+
+/**
+ * @brief Answers the spread queries received on the Unix socket given by the
+ * options, until the program is interrupted. Each request line is an id and
+ * its reply is a "COUNT LATENCY" line, the latency in microseconds. The
+ * amount of queries and their latencies are written on the standard error.
+ *
+ * @param options The options.
+ * @param query The structures the queries are answered with.
+ * @return int Program's exit status code.
+ */
+static int serveQueries(Options *options, TableQuery *query) {
+    Server *server = Server_create(options->servePath);
+    if (server == NULL) {
+        fprintf(stderr, "Could not listen on: %s\n", options->servePath);
+        return 1;
+    }
+
+    fprintf(stderr, "Serving on %s\n", options->servePath);
+    fflush(stdout);
+    int status = Server_run(server, answerTableQuery, query) ? 0 : 1;
+
+    long long queries = Server_getQueries(server);
+    fprintf(stderr, "Served %lld queries, latency mean %.1f us, max %.1f us\n",
+        queries, queries ? Server_getLatencySum(server) / queries : 0.0,
+        Server_getLatencyMax(server));
+    Server_destroy(server);
+    return status;
+}
+
+/**
+ * @brief Releases the structures of a query on the person table that were
+ * created, and the input.
+ *
+ * @param query The structures, NULL the ones not created.
+ * @param input The input.
+ * @param status The exit status code to return.
+ * @return int The given status.
+ */
+static int releaseTable(TableQuery *query, Input *input, int status) {
+    free(query->levels);
+    if (query->csr) {
+        CsrGraph_destroy(query->csr);
+    }
+    if (query->compact) {
+        CompactGraph_destroy(query->compact);
+    }
+    if (query->parallelBfs) {
+        ParallelBfs_destroy(query->parallelBfs);
+    }
+    if (query->index) {
+        PersonIndex_destroy(query->index);
+    }
+    if (query->spreadIndex) {
+        SpreadIndex_destroy(query->spreadIndex);
+    }
+    PersonTable_destroy(query->table);
+    Input_close(input);
+    return status;
+}
+
+/**
+ * @brief Loads the people on a person table and the edges on a CSR graph,
+ * then answers the spread queries, like main does with the vertices.
+ *
+ * The "--spread=recursive" traversal is answered by the depth first one.
+ *
+ * @param options The options.
+ * @param input The input, positioned after its header.
+ * @param n The amount of people.
+ * @param m The amount of edges.
+ * @return int Program's exit status code.
+ */
+static int runTable(Options *options, Input *input, int n, int m) {
+    TableQuery query;
+    query.options = options;
+    query.table = PersonTable_create(n);
+    query.index = NULL;
+    query.spreadIndex = NULL;
+    query.csr = NULL;
+    query.compact = NULL;
+    query.parallelBfs = NULL;
+    query.levels = NULL;
+
+    // The ids are copied into the table, so the people cost no allocation.
+    int i = Pipeline_readTablePeople(input, query.table, n);
+    if (i < n) {
+        fprintf(stderr, "Invalid person number %d\n", i + 1);
+        return releaseTable(&query, input, 1);
+    }
+
+    METRICS_PHASE("sort/index");
+    if (options->hash) {
+        query.index = PersonIndex_createFromTable(query.table);
+    } else {
+        PersonTable_sortById(query.table, options->sort, options->threads);
+    }
+
+    if (options->index) {
+        unsigned char *eligible = PersonTable_createEligibleFlags(query.table);
+        query.spreadIndex = SpreadIndex_create(eligible, n);
+        free(eligible);
+    }
+
+    METRICS_PHASE("edges");
+    // With the spread index, the edges are only stored for the snapshot.
+    if (options->parallelLoad && !query.spreadIndex) {
+        query.csr = ParallelLoader_loadEdges(input, m, NULL, query.table,
+            query.index, options->threads);
+    } else {
+        if (!query.spreadIndex || options->writeSnapshotPath) {
+            query.csr = CsrGraph_create(n);
+        }
+        Pipeline_readTableEdges(input, m, query.table, query.index, query.csr,
+            query.spreadIndex);
+    }
+    // The spread index is built on the load order and answers without
+    // traversals, so the vertices are not relabeled under it.
+    if (query.csr && !query.spreadIndex && options->reorder != REORDER_NONE) {
+        METRICS_PHASE("reorder");
+        reorderTable(options, &query.table, &query.csr, &query.index);
+    }
+
+    if (options->writeSnapshotPath &&
+        !Snapshot_write(options->writeSnapshotPath, query.table, query.csr)) {
+        fprintf(stderr, "Could not write the snapshot: %s\n",
+            options->writeSnapshotPath);
+    }
+    if (options->compact) {
+        METRICS_PHASE("compact");
+        query.compact = compactGraph(options, &query.csr);
+    }
+    if (options->parallel && query.csr) {
+        query.parallelBfs = PersonTable_createParallelBfs(query.table,
+            query.csr, options->threads);
+    }
+
+    METRICS_PHASE("spread");
+    char *first_id = Input_nextToken(input, NULL);
+    if (options->multiSeed && !query.spreadIndex) {
+        spreadSeeds(NULL, query.table, query.index, query.csr, input,
+            first_id);
+        first_id = NULL;
+    }
+    if (first_id == NULL && !options->batch) {
+        printf("0\n");
+    }
+    if (options->hops >= 0) {
+        query.levels = (int *) malloc((options->hops + 1) * sizeof(int));
+        if (query.levels == NULL) {
+            fprintf(stderr, "Could not allocate the counts of %d hops\n",
+                options->hops);
+            return releaseTable(&query, input, 1);
+        }
+    }
+    char **seed_ids = NULL;
+    int seeds_number = 0;
+    while (first_id != NULL) {
+        int counter = 0;
+        if (options->watchPath) {
+            // The seeds keep the table copy of the id, which outlives the
+            // input window of "--stream".
+            int start_index = Pipeline_searchTablePerson(query.table,
+                query.index, first_id);
+            if (start_index >= 0) {
+                seed_ids = (char **) realloc(seed_ids, (seeds_number + 1) *
+                    sizeof(char *));
+                seed_ids[seeds_number] = PersonTable_getId(query.table,
+                    start_index);
+                seeds_number = SpreadIndex_registerSeed(query.spreadIndex,
+                    start_index) + 1;
+                counter = SpreadIndex_getSeedCount(query.spreadIndex,
+                    seeds_number - 1);
+            }
+        } else {
+            counter = answerTableQuery(&query, first_id);
+        }
+        if (query.levels) {
+            printLevels(query.levels, options->hops);
+        } else {
+            printf("%d\n", counter);
+        }
+
+        if (!options->batch) {
+            break;
+        }
+        first_id = Input_nextToken(input, NULL);
+    }
+
+    int status = 0;
+    if (options->watchPath) {
+        status = watchEdges(options, NULL, query.table, query.index,
+            query.spreadIndex, seed_ids);
+        free(seed_ids);
+    }
+    if (options->servePath && status == 0) {
+        METRICS_PHASE("serve");
+        status = serveQueries(options, &query);
+    }
+
+    METRICS_PHASE("teardown");
+    return releaseTable(&query, input, status);
+}
+
+/**
+ * @brief Writes an edge of the input on the external graph, in both
+ * directions. The spread only goes through eligible people, so only the edges
+ * between two of them are written.
+ *
+ * @param context The ExternalQuery.
+ * @param id1 The first person's id.
+ * @param id2 The second person's id.
+ * @return int Always 1.
+ */
+static int insertExternalEdge(void *context, char *id1, char *id2) {
+    ExternalQuery *query = (ExternalQuery *) context;
+    int index1 = Pipeline_searchTablePerson(query->table, query->index, id1);
+    int index2 = Pipeline_searchTablePerson(query->table, query->index, id2);
+
+    if (index1 >= 0 && index2 >= 0 && query->eligible[index1] &&
+        query->eligible[index2]) {
+        ExternalGraph_insertEdge(query->graph, index1, index2);
+        ExternalGraph_insertEdge(query->graph, index2, index1);
+    }
+    return 1;
+}
+
+/**
+ * @brief Releases the structures of a query on the external graph that were
+ * created, and the input.
+ *
+ * @param query The structures, NULL the ones not created.
+ * @param input The input.
+ * @param status The exit status code to return.
+ * @return int The given status.
+ */
+static int releaseExternal(ExternalQuery *query, Input *input, int status) {
+    if (query->graph) {
+        ExternalGraph_destroy(query->graph);
+    }
+    if (query->index) {
+        PersonIndex_destroy(query->index);
+    }
+    free(query->visited);
+    free(query->eligible);
+    PersonTable_destroy(query->table);
+    Input_close(input);
+    return status;
+}
+
+/**
+ * @brief Loads the people on a person table and the edges on an external
+ * graph, partitioned on disk, then answers the spread queries with
+ * semi-external searches. The I/O volume is written on the standard error.
+ *
+ * @param options The options.
+ * @param input The input, positioned after its header.
+ * @param n The amount of people.
+ * @param m The amount of edges.
  * @return int Program's exit status code.
  */
-int main() {
-    int n, m, i;
-    scanf("%d %d", &n, &m);
+static int runExternal(Options *options, Input *input, int n, int m) {
+    ExternalQuery query;
+    query.table = PersonTable_create(n);
+    query.index = NULL;
+    query.eligible = NULL;
+    query.graph = NULL;
+    query.visited = NULL;
+
+    int i = Pipeline_readTablePeople(input, query.table, n);
+    if (i < n) {
+        fprintf(stderr, "Invalid person number %d\n", i + 1);
+        return releaseExternal(&query, input, 1);
+    }
+
+    METRICS_PHASE("sort/index");
+    if (options->hash) {
+        query.index = PersonIndex_createFromTable(query.table);
+    } else {
+        PersonTable_sortById(query.table, options->sort, options->threads);
+    }
+    query.eligible = PersonTable_createEligibleFlags(query.table);
+
+    METRICS_PHASE("edges");
+    query.graph = ExternalGraph_create(options->externalPath, n,
+        options->partitions);
+    if (query.graph == NULL) {
+        fprintf(stderr, "Could not create the edge partitions on: %s\n",
+            options->externalPath);
+        return releaseExternal(&query, input, 1);
+    }
+    Pipeline_readEdgesWith(input, m, insertExternalEdge, &query);
+    if (!ExternalGraph_build(query.graph)) {
+        fprintf(stderr, "Could not write the edge partitions on: %s\n",
+            options->externalPath);
+        return releaseExternal(&query, input, 1);
+    }
+
+    METRICS_PHASE("spread");
+    size_t visitedBytes = PARALLEL_BFS_WORDS(n) * sizeof(unsigned long long);
+    query.visited = (unsigned long long *) calloc(PARALLEL_BFS_WORDS(n) + 1,
+        sizeof(unsigned long long));
+    char *first_id = Input_nextToken(input, NULL);
+    if (first_id == NULL && !options->batch) {
+        printf("0\n");
+    }
+    int status = 0;
+    while (first_id != NULL) {
+        int start_index = Pipeline_searchTablePerson(query.table, query.index,
+            first_id);
+        int counter = start_index >= 0 ? ExternalGraph_search(query.graph,
+            query.eligible, start_index, query.visited) : 0;
+        if (counter < 0) {
+            fprintf(stderr, "Could not read the edge partitions on: %s\n",
+                options->externalPath);
+            status = 1;
+            break;
+        }
+        printf("%d\n", counter);
+
+        if (!options->batch) {
+            break;
+        }
+        memset(query.visited, 0, visitedBytes);
+        first_id = Input_nextToken(input, NULL);
+    }
 
-    Graph *graph = Graph_create(n);
+    fprintf(stderr, "External I/O: %lld bytes written, %lld bytes read, "
+        "%lld partition scans\n", ExternalGraph_getBytesWritten(query.graph),
+        ExternalGraph_getBytesRead(query.graph),
+        ExternalGraph_getPartitionScans(query.graph));
+
+    METRICS_PHASE("teardown");
+    return releaseExternal(&query, input, status);
+}
+
+/**
+ * @brief Inserts a person of the input on the mutable person graph.
+ *
+ * @param context The person graph.
+ * @param position The person's position on the input.
+ * @param id The person's id.
+ * @param age The person's age.
+ */
+static void insertDynamicPerson(void *context, int position, char *id,
+    int age) {
+    (void) position;
+    PersonGraph_insertPerson((PersonGraph *) context, id, age);
+}
+
+/**
+ * @brief Inserts an edge of the input on the mutable person graph. Edges with
+ * an unknown id are skipped.
+ *
+ * @param context The person graph.
+ * @param id1 The first person's id.
+ * @param id2 The second person's id.
+ * @return int Always 1.
+ */
+static int insertDynamicEdge(void *context, char *id1, char *id2) {
+    PersonGraph_insertEdge((PersonGraph *) context, id1, id2);
+    return 1;
+}
+
+/**
+ * @brief Releases the mutable person graph, the updates, if they were opened,
+ * and the input.
+ *
+ * @param graph The person graph.
+ * @param updates The updates, or NULL.
+ * @param input The input.
+ * @param status The exit status code to return.
+ * @return int The given status.
+ */
+static int releaseDynamic(PersonGraph *graph, Input *updates, Input *input,
+    int status) {
+    if (updates) {
+        Input_close(updates);
+    }
+    PersonGraph_destroy(graph);
+    Input_close(input);
+    return status;
+}
+
+/**
+ * @brief Loads the people and edges on a mutable person graph, applies the
+ * updates file, if any, and then answers the spread queries.
+ *
+ * @param options The options.
+ * @param input The input, positioned after its header.
+ * @param n The amount of people.
+ * @param m The amount of edges.
+ * @return int Program's exit status code.
+ */
+static int runDynamic(Options *options, Input *input, int n, int m) {
+    PersonGraph *graph = PersonGraph_create();
+
+    int i = Pipeline_readPeopleWith(input, n, insertDynamicPerson, graph);
+    if (i < n) {
+        fprintf(stderr, "Invalid person number %d\n", i + 1);
+        return releaseDynamic(graph, NULL, input, 1);
+    }
+
+    METRICS_PHASE("edges");
+    Pipeline_readEdgesWith(input, m, insertDynamicEdge, graph);
+
+    if (options->updatesPath) {
+        METRICS_PHASE("updates");
+        Input *updates = Input_open(options->updatesPath);
+        if (updates == NULL) {
+            fprintf(stderr, "Could not open the updates: %s\n",
+                options->updatesPath);
+            return releaseDynamic(graph, NULL, input, 1);
+        }
+        if (PersonGraph_applyUpdates(graph, updates) < 0) {
+            fprintf(stderr, "Invalid update on: %s\n", options->updatesPath);
+            return releaseDynamic(graph, updates, input, 1);
+        }
+        Input_close(updates);
+    }
+
+    METRICS_PHASE("spread");
+    char *first_id = Input_nextToken(input, NULL);
+    if (first_id == NULL && !options->batch) {
+        printf("0\n");
+    }
+    while (first_id != NULL) {
+        int start_index = PersonGraph_search(graph, first_id);
+        printf("%d\n", start_index >= 0 ?
+            PersonGraph_spreadMusic(graph, start_index) : 0);
+
+        if (!options->batch) {
+            break;
+        }
+        first_id = Input_nextToken(input, NULL);
+    }
+
+    METRICS_PHASE("teardown");
+    return releaseDynamic(graph, NULL, input, 0);
+}
+
+/**
+ * @brief Releases the structures of a query on the graph that were created,
+ * the people and vertices, and the input.
+ *
+ * @param query The structures, NULL the ones not created.
+ * @param input The input.
+ * @param status The exit status code to return.
+ * @return int The given status.
+ */
+static int releaseGraph(GraphQuery *query, Input *input, int status) {
+    free(query->levels);
+    if (query->csr) {
+        CsrGraph_destroy(query->csr);
+    }
+    if (query->compact) {
+        CompactGraph_destroy(query->compact);
+    }
+    if (query->parallelBfs) {
+        ParallelBfs_destroy(query->parallelBfs);
+    }
+    if (query->index) {
+        PersonIndex_destroy(query->index);
+    }
+    if (query->spreadIndex) {
+        SpreadIndex_destroy(query->spreadIndex);
+    }
+    if (query->ageIndex) {
+        AgeIndex_destroy(query->ageIndex);
+    }
+    if (query->arena) {
+        Arena_destroy(query->arena);
+    } else {
+        Graph_destroyPeople(query->graph);
+    }
+    Graph_destroy(query->graph);
+    Input_close(input);
+    return status;
+}
+
+/**
+ * @brief Loads the people on the graph vertices and the edges on the
+ * structure selected by the options, then answers the spread queries.
+ *
+ * @param options The options.
+ * @param input The input, positioned after its header.
+ * @param n The amount of people.
+ * @param m The amount of edges.
+ * @return int Program's exit status code.
+ */
+static int runGraph(Options *options, Input *input, int n, int m) {
+    GraphQuery query;
+    query.graph = Graph_create(n);
+    query.arena = options->arena ? Arena_create() : NULL;
+    query.index = NULL;
+    query.spreadIndex = NULL;
+    query.ageIndex = NULL;
+    query.csr = options->csr && !options->parallelLoad ?
+        CsrGraph_create(n) : NULL;
+    query.compact = NULL;
+    query.parallelBfs = NULL;
+    query.levels = NULL;
 
     // Complexity for create all vertices is O(V), being V = "n".
-    for (i = 0; i < n; i += 1) {
-        char *id = (char *) malloc(sizeof(char) * MAX_ID_LENGTH);
-        int age;
-        scanf("%s %d", id, &age);
-        Graph_insertVertex(graph, Vertex_create(Person_create(id, age)), i);
+    // The ids point to the input buffer, which lives until the end.
+    int i = Pipeline_readPeople(input, query.graph, query.arena, n);
+    if (i < n) {
+        fprintf(stderr, "Invalid person number %d\n", i + 1);
+        return releaseGraph(&query, input, 1);
     }
 
-    Graph_sortVerticesByPersonId(graph);
+    METRICS_PHASE("sort/index");
+    query.index = Pipeline_indexPeople(query.graph, options->hash,
+        options->sort, options->threads);
+
+    if (options->index) {
+        query.spreadIndex = Graph_createSpreadIndex(query.graph);
+    }
+    if (options->ageIndex) {
+        query.ageIndex = Graph_createAgeIndex(query.graph);
+        if (query.ageIndex == NULL) {
+            fprintf(stderr, "Could not allocate the age index\n");
+            return releaseGraph(&query, input, 1);
+        }
+    }
 
-    char *id1 = (char *) malloc(sizeof(char) * MAX_ID_LENGTH);
-    char *id2 = (char *) malloc(sizeof(char) * MAX_ID_LENGTH);
+    METRICS_PHASE("edges");
     // Complexity for set all edges is O(E*log(V)), being V = "n",and E = "m".
-    for (i = 0; i < m; i += 1) {
-        scanf("%s %s", id1, id2);
-        Vertex *vertex1 = Graph_searchPersonVertexById(graph, id1);
-        Vertex *vertex2 = Graph_searchPersonVertexById(graph, id2);
-        if (vertex1 && vertex2) {
-            Vertex_setEdge(vertex1, vertex2, 0);
+    // With the hash index it is O(E) expected.
+    if (options->parallelLoad && !query.spreadIndex && !query.ageIndex) {
+        query.csr = ParallelLoader_loadEdges(input, m, query.graph, NULL,
+            query.index, options->threads);
+    } else if (!Pipeline_readEdges(input, m, query.graph, query.index,
+        query.csr, query.spreadIndex, query.ageIndex)) {
+        fprintf(stderr, "Could not allocate the age index\n");
+        return releaseGraph(&query, input, 1);
+    }
+    // The indices are built on the load order and answer without traversals,
+    // so the vertices are not relabeled under them.
+    if (query.csr && !query.spreadIndex && !query.ageIndex &&
+        options->reorder != REORDER_NONE) {
+        METRICS_PHASE("reorder");
+        reorderGraph(options, query.graph, &query.csr, &query.index);
+    }
+    if (options->compact) {
+        METRICS_PHASE("compact");
+        query.compact = compactGraph(options, &query.csr);
+    }
+    if (options->parallel && query.csr) {
+        query.parallelBfs = Graph_createParallelBfs(query.graph, query.csr,
+            options->threads);
+    }
+
+    // Complexity for each spread is O(V+E).
+    METRICS_PHASE("spread");
+    char **seed_ids = NULL;
+    int seeds_number = 0;
+    if (options->hops >= 0) {
+        query.levels = (int *) malloc((options->hops + 1) * sizeof(int));
+        if (query.levels == NULL) {
+            fprintf(stderr, "Could not allocate the counts of %d hops\n",
+                options->hops);
+            return releaseGraph(&query, input, 1);
         }
     }
+    char *first_id = Input_nextToken(input, NULL);
+    if (query.ageIndex) {
+        answerThresholds(query.graph, query.index, query.ageIndex, input,
+            first_id);
+        first_id = NULL;
+    }
+    if (options->multiSeed && !query.spreadIndex && !query.ageIndex) {
+        spreadSeeds(query.graph, NULL, query.index, query.csr, input,
+            first_id);
+        first_id = NULL;
+    }
+    if (first_id == NULL && !options->batch) {
+        printf("0\n");
+    }
+    while (first_id != NULL) {
+        int start_index = Pipeline_searchPerson(query.graph, query.index,
+            first_id);
+        int counter = 0;
+        if (start_index >= 0 && options->watchPath) {
+            seed_ids = (char **) realloc(seed_ids, (seeds_number + 1) *
+                sizeof(char *));
+            seed_ids[seeds_number] = first_id;
+            seeds_number = SpreadIndex_registerSeed(query.spreadIndex,
+                start_index) + 1;
+            counter = SpreadIndex_getSeedCount(query.spreadIndex,
+                seeds_number - 1);
+        } else if (start_index >= 0 && query.spreadIndex) {
+            counter = SpreadIndex_getCount(query.spreadIndex, start_index);
+        } else if (start_index >= 0 && query.levels) {
+            spreadLevels(options, query.graph, query.csr, start_index,
+                query.levels);
+        } else if (start_index >= 0) {
+            counter = Pipeline_spreadMusic(query.graph, query.csr,
+                query.compact, query.parallelBfs, start_index,
+                options->recursive, options->strategy);
+        }
 
-    char *first_id = (char *) malloc(sizeof(char) * MAX_ID_LENGTH);
-    int counter = 0;
-    scanf("%s", first_id);
-    Vertex *start_vertex = Graph_searchPersonVertexById(graph, first_id);
-    if (start_vertex) {
-        Person_spreadMusic(start_vertex, &counter);
+        if (query.levels) {
+            if (start_index < 0) {
+                query.levels[0] = 0;
+            }
+            printLevels(query.levels, options->hops);
+        } else {
+            printf("%d\n", counter);
+        }
+
+        if (!options->batch) {
+            break;
+        }
+        Person_resetSpread();
+        first_id = Input_nextToken(input, NULL);
+    }
+
+    int status = 0;
+    if (options->watchPath) {
+        status = watchEdges(options, query.graph, NULL, query.index,
+            query.spreadIndex, seed_ids);
+        free(seed_ids);
     }
-    printf("%d\n", counter);
 
-    free(id1);
-    free(id2);
-    free(first_id);
-    Graph_destroyPeople(graph);
-    Graph_destroy(graph);
+    METRICS_PHASE("teardown");
+    return releaseGraph(&query, input, status);
+}
 
-    return 0;
-}
\ No newline at end of file
+/**
+ * @brief Main funcition.
+ *
+ * It will create and destroy the graph, the vertices and the edges given the
+ * user entries, and it will calculate how many people liked the music hit after
+ * the spread.
+ *
+ * If the "--csr" argument is given, the edges are stored on a CSR graph
+ * instead of the vertices edges lists, and the spread runs over the vertices
+ * indices.
+ *
+ * If the "--reorder=rcm" or "--reorder=degree" argument is given, after the
+ * edges are loaded the vertices are relabeled on the reverse Cuthill-McKee
+ * order or by decreasing degree, so the people visited together by a spread
+ * are close on memory (it implies "--csr"). The ids are then found through
+ * the hash index, rebuilt on the new order.
+ *
+ * If the "--compact" argument is given, after the edges are loaded the CSR
+ * graph is replaced by a compact graph, whose sorted neighbor lists are
+ * stored as variable length gaps, and the spread decodes them while visiting
+ * (it implies "--csr"). "--spread=recursive" is answered by the depth first
+ * traversal, and "--spread=parallel" and "--multi-seed" keep the CSR graph.
+ *
+ * If the "--hash" argument is given, the vertices are not sorted and the
+ * people are found through a hash index on their ids. Otherwise,
+ * "--sort=quicksort" (default) or "--sort=multikey" select the ids sort. The
+ * multikey one runs with "--threads=N" threads and gives the same order.
+ *
+ * The "--spread=dfs" (default), "--spread=bfs" and "--spread=recursive"
+ * arguments select the traversal used to spread the music. The iterative ones
+ * do not depend on the call stack size, so they survive deep graphs.
+ * "--spread=parallel" uses a multithreaded breadth first search over the CSR
+ * graph (it implies "--csr"), with the amount of threads given by
+ * "--threads=N".
+ *
+ * The input is read from the standard input, or mapped from the file given by
+ * "--input=PATH".
+ *
+ * If the "--arena" argument is given, the people, the vertices and their
+ * edges lists are allocated on an arena, which is released at once.
+ *
+ * If the "--batch" argument is given, every id after the edges is the first
+ * listener of a new spread over the same graph, and one count is printed for
+ * each of them. The listened marks are reset between the spreads.
+ *
+ * If the "--index" argument is given, the edges are not stored: they are
+ * merged on a spread index while read, and every count is an array lookup.
+ * No one is marked as listened in this mode.
+ *
+ * If the "--age-index" argument is given, every query after the edges is an
+ * "ID THRESHOLD" pair (it implies "--batch"), and its count uses the
+ * threshold as the age limit instead of 35. The edges are not stored: they
+ * are merged on a Kruskal reconstruction tree, built by adding the people in
+ * increasing age order, and each count is an O(log(V)) walk up the tree.
+ * The age index is built over the vertices of the graph, so it can not be
+ * combined with "--index", "--watch", "--stream", "--table", "--serve",
+ * "--write-snapshot", "--multi-seed", "--dynamic", "--external" or
+ * "--snapshot".
+ *
+ * If the "--watch=PATH" argument is given, every id after the edges is
+ * registered on the spread index as a seed (it implies "--index" and
+ * "--batch"), and then the edges of the file are inserted one by one. After
+ * each insertion, the new count of every seed it changed is printed as an
+ * "ID COUNT" line. It works on the graph and on the person table, but not with
+ * "--dynamic", "--external" or "--snapshot".
+ *
+ * If the "--multi-seed" argument is given, all the ids after the edges are
+ * read first and then answered together by a bit parallel spread over the
+ * CSR graph, which propagates 64 first listeners on each traversal (it
+ * implies "--batch" and "--csr"). No one is marked as listened.
+ *
+ * If the "--parallel-load" argument is given, the edges section is parsed,
+ * resolved and scattered into the CSR graph by "--threads=N" threads (it
+ * implies "--csr"). Each edge must be on its own line.
+ *
+ * If the "--table" argument is given, the people are stored on a person
+ * table, as dense arrays indexed like the CSR graph (it implies "--csr").
+ *
+ * If the "--stream" argument is given, the input is read on a sliding window
+ * instead of being loaded whole, the people are stored on a person table and
+ * the edges are only merged on the spread index (it implies "--table" and
+ * "--index"). The memory is O(V) integers plus the ids, whatever "m" is.
+ *
+ * If the "--dynamic" argument is given, the people and edges are stored on a
+ * mutable graph. "--updates=PATH" (which implies it) applies a file of
+ * "+person ID AGE", "-person ID", "+edge ID1 ID2" and "-edge ID1 ID2" lines
+ * after the load, before the queries.
+ *
+ * If the "--external=DIR" argument is given, the input is streamed like with
+ * "--stream", the people are stored on a person table and the edges between
+ * people younger than 35 are written on "--partitions=N" files on the
+ * directory, split by vertex ranges. Each spread is a breadth first search
+ * that keeps only bitmaps on memory and reads, sequentially and in a circular
+ * order, the partitions holding frontier vertices, each one until it reaches
+ * no more vertices on itself. The bytes written and read are printed on the
+ * standard error.
+ *
+ * If the "--write-snapshot=PATH" argument is given, the loaded graph is
+ * written on a binary snapshot (it implies "--table"). If the "--snapshot=PATH"
+ * argument is given, the graph is mapped from the snapshot instead, and the
+ * input holds only the ids of the first listeners.
+ *
+ * If the "--hops=K" argument is given, each spread is a breadth first search
+ * that stops after K hops, or at the first empty hop, and each query prints
+ * on a line how many people liked the music within 0, 1, ..., K hops, up to
+ * the last hop the music reached. Only the people within K hops are explored.
+ * It can not be combined with the options whose queries are not answered by a
+ * sequential traversal over the stored edges:
+ * "--index", "--stream", "--watch", "--age-index", "--multi-seed",
+ * "--spread=parallel", "--dynamic", "--external" and "--snapshot".
+ *
+ * If the "--serve=PATH" argument is given, after the queries of the input are
+ * answered, the loaded graph is kept and the program listens on a Unix socket
+ * on the path (it implies "--table" and "--batch"). Each line received is a
+ * first listener id and is answered by a "COUNT LATENCY" line, the latency in
+ * microseconds, on the request order. Several connections are served, and a
+ * client may send many lines before reading the replies. SIGINT or SIGTERM
+ * stop the server, which writes the latency summary on the standard error.
+ *
+ * On builds with TP0_METRICS defined ("make METRICS=1"), the wall and CPU
+ * times of each phase, the hot path counters and the peak resident memory are
+ * written on the standard error as a JSON line before the program exits.
+ *
+ * Final complexity: O(E*V*log(V)), being V = "n" and E = "m". The most
+ * expensive parts are the vertices array sort and edges processing.
+ *
+ * @param argc The arguments count.
+ * @param argv The arguments.
+ * @return int Program's exit status code.
+ */
+int main(int argc, char *argv[]) {
+    int n, m, status;
+    Options options;
+
+    if (!parseOptions(argc, argv, &options)) {
+        return 1;
+    }
+
+    METRICS_PHASE("ingest");
+    Input *input = options.stream || options.externalPath ?
+        Input_openStream(options.inputPath) : Input_open(options.inputPath);
+    if (input == NULL) {
+        fprintf(stderr, "Could not open the input: %s\n", options.inputPath);
+        return 1;
+    }
+    if (options.snapshotPath) {
+        status = runSnapshot(&options, input);
+        METRICS_REPORT();
+        return status;
+    }
+    if (!Input_nextInt(input, &n) || !Input_nextInt(input, &m) ||
+        n < 0 || m < 0) {
+        fprintf(stderr, "Invalid input header\n");
+        Input_close(input);
+        return 1;
+    }
+    // A spread never travels more than n - 1 hops.
+    if (options.hops > n) {
+        options.hops = n;
+    }
+    if (options.externalPath) {
+        status = runExternal(&options, input, n, m);
+        METRICS_REPORT();
+        return status;
+    }
+    if (options.dynamic) {
+        status = runDynamic(&options, input, n, m);
+        METRICS_REPORT();
+        return status;
+    }
+    if (options.table) {
+        status = runTable(&options, input, n, m);
+        METRICS_REPORT();
+        return status;
+    }
+
+    status = runGraph(&options, input, n, m);
+    METRICS_REPORT();
+    return status;
+}